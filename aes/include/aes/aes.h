@@ -12,6 +12,7 @@
 #include "workarounds.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +26,138 @@ AES_Block AES_ASM_ATTR aes128_decrypt_block_internal(AES_Block, const AES128_Rou
 AES_Block AES_ASM_ATTR aes192_decrypt_block_internal(AES_Block, const AES192_RoundKeys*);
 AES_Block AES_ASM_ATTR aes256_decrypt_block_internal(AES_Block, const AES256_RoundKeys*);
 
+/* The multi-block versions keep up to 8 independent blocks in flight.
+ * The blocks don't have to be aligned, and the input and the output may point
+ * to the same array. */
+
+void AES_ASM_ATTR aes128_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys*
+);
+
+void AES_ASM_ATTR aes128_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys*
+);
+
+/* Encrypts two blocks in lockstep, for the modes that always have exactly two
+ * independent blocks at hand (like CCM's MAC & keystream blocks). */
+
+void AES_ASM_ATTR aes128_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys*
+);
+
+/* The chained modes can't process independent blocks in lockstep, but the
+ * round keys are only loaded once per call.
+ * iv is updated to the last block of the chain: the last ciphertext block in
+ * CBC & CFB modes, the last keystream block in OFB mode. */
+
+void AES_ASM_ATTR aes128_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys*
+);
+
+void AES_ASM_ATTR aes128_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys*
+);
+
+void AES_ASM_ATTR aes128_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys*
+);
+void AES_ASM_ATTR aes192_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys*
+);
+void AES_ASM_ATTR aes256_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys*
+);
+
 static inline AES_Block aes128_encrypt_block(AES_Block plaintext, const AES128_RoundKeys* keys) {
     assert(keys);
     return aes128_encrypt_block_internal(plaintext, keys);
@@ -55,6 +188,237 @@ static inline AES_Block aes256_decrypt_block(AES_Block ciphertext, const AES256_
     return aes256_decrypt_block_internal(ciphertext, keys);
 }
 
+static inline void aes128_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(keys);
+    aes128_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, keys);
+}
+
+static inline void aes192_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(keys);
+    aes192_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, keys);
+}
+
+static inline void aes256_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(keys);
+    aes256_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, keys);
+}
+
+static inline void aes128_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* keys
+) {
+    assert(ciphertext || numof_blocks == 0);
+    assert(plaintext || numof_blocks == 0);
+    assert(keys);
+    aes128_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, keys);
+}
+
+static inline void aes192_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* keys
+) {
+    assert(ciphertext || numof_blocks == 0);
+    assert(plaintext || numof_blocks == 0);
+    assert(keys);
+    aes192_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, keys);
+}
+
+static inline void aes256_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* keys
+) {
+    assert(ciphertext || numof_blocks == 0);
+    assert(plaintext || numof_blocks == 0);
+    assert(keys);
+    aes256_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, keys);
+}
+
+static inline void aes128_encrypt_pair(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys* keys
+) {
+    assert(plaintext);
+    assert(ciphertext);
+    assert(keys);
+    aes128_encrypt_pair_internal(plaintext, ciphertext, keys);
+}
+
+static inline void aes192_encrypt_pair(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys* keys
+) {
+    assert(plaintext);
+    assert(ciphertext);
+    assert(keys);
+    aes192_encrypt_pair_internal(plaintext, ciphertext, keys);
+}
+
+static inline void aes256_encrypt_pair(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys* keys
+) {
+    assert(plaintext);
+    assert(ciphertext);
+    assert(keys);
+    aes256_encrypt_pair_internal(plaintext, ciphertext, keys);
+}
+
+static inline void aes128_encrypt_cbc(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes128_encrypt_cbc_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes192_encrypt_cbc(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes192_encrypt_cbc_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes256_encrypt_cbc(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes256_encrypt_cbc_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes128_encrypt_cfb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes128_encrypt_cfb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes192_encrypt_cfb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes192_encrypt_cfb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes256_encrypt_cfb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes256_encrypt_cfb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes128_encrypt_ofb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes128_encrypt_ofb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes192_encrypt_ofb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes192_encrypt_ofb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
+static inline void aes256_encrypt_ofb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* keys
+) {
+    assert(plaintext || numof_blocks == 0);
+    assert(ciphertext || numof_blocks == 0);
+    assert(iv);
+    assert(keys);
+    aes256_encrypt_ofb_internal(plaintext, ciphertext, numof_blocks, iv, keys);
+}
+
 #ifdef __cplusplus
 }
 #endif
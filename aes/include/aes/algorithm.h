@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -53,6 +55,7 @@ typedef AES_StatusCode (*AES_FormatKey)(
     AES_ErrorDetails* err_details
 );
 
+/* The decryption keys can be NULL if only the encryption keys are needed. */
 typedef AES_StatusCode (*AES_ExpandKey)(
     const AES_Key* params,
     AES_EncryptionRoundKeys*,
@@ -74,12 +77,90 @@ typedef AES_StatusCode (*AES_DecryptBlock)(
     AES_ErrorDetails* err_details
 );
 
+typedef AES_StatusCode (*AES_EncryptBlocks)(
+    const AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_EncryptionRoundKeys* params,
+    AES_Block* ciphertext,
+    AES_ErrorDetails* err_details
+);
+
+typedef AES_StatusCode (*AES_DecryptBlocks)(
+    const AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_DecryptionRoundKeys* params,
+    AES_Block* plaintext,
+    AES_ErrorDetails* err_details
+);
+
+/* The block functions without any checks or error reporting, for the callers
+ * that have checked the arguments already: the pointers mustn't be NULL
+ * (unless numof_blocks is 0), and the round keys must have been expanded by
+ * the same implementation.
+ * The checked functions above do the checks & call these. */
+
+typedef AES_Block (*AES_EncryptBlockUnchecked)(
+    AES_Block plaintext,
+    const AES_EncryptionRoundKeys* params
+);
+
+typedef AES_Block (*AES_DecryptBlockUnchecked)(
+    AES_Block ciphertext,
+    const AES_DecryptionRoundKeys* params
+);
+
+typedef void (*AES_EncryptBlocksUnchecked)(
+    const AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_EncryptionRoundKeys* params,
+    AES_Block* ciphertext
+);
+
+typedef void (*AES_DecryptBlocksUnchecked)(
+    const AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_DecryptionRoundKeys* params,
+    AES_Block* plaintext
+);
+
+/* Encrypts numof_blocks blocks in one of the chained modes (CBC, CFB or OFB)
+ * & updates iv, loading the round keys once per call. */
+typedef void (*AES_EncryptChainUnchecked)(
+    const AES_Block* plaintext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_EncryptionRoundKeys* params,
+    AES_Block* ciphertext
+);
+
+/* Encrypts two independent blocks together, which is faster than encrypting
+ * them one after another. */
+typedef void (*AES_EncryptPairUnchecked)(
+    const AES_Block* plaintext,
+    const AES_EncryptionRoundKeys* params,
+    AES_Block* ciphertext
+);
+
+typedef struct {
+    AES_EncryptBlockUnchecked encrypt_block;
+    AES_DecryptBlockUnchecked decrypt_block;
+    AES_EncryptBlocksUnchecked encrypt_blocks;
+    AES_DecryptBlocksUnchecked decrypt_blocks;
+    AES_EncryptPairUnchecked encrypt_pair;
+    AES_EncryptChainUnchecked encrypt_cbc;
+    AES_EncryptChainUnchecked encrypt_cfb;
+    AES_EncryptChainUnchecked encrypt_ofb;
+} AES_UncheckedOps;
+
 typedef struct {
     AES_ParseKey parse_key;
     AES_FormatKey format_key;
     AES_ExpandKey expand_key;
     AES_EncryptBlock encrypt_block;
     AES_DecryptBlock decrypt_block;
+    AES_EncryptBlocks encrypt_blocks;
+    AES_DecryptBlocks decrypt_blocks;
+    const AES_UncheckedOps* unchecked;
 } AES_Ops;
 
 const AES_Ops* aes_get_ops(AES_Algorithm);
@@ -11,10 +11,18 @@
 #include "algorithm.h"
 #include "block.h"
 #include "box.h"
+#include "cmac.h"
+#include "drbg.h"
 #include "error.h"
+#include "ghash.h"
 #include "hex.h"
+#include "impl.h"
 #include "key.h"
+#include "kw.h"
 #include "mode.h"
 #include "padding.h"
+#include "portable.h"
 #include "round_keys.h"
+#include "vaes.h"
+#include "vperm.h"
 #include "workarounds.h"
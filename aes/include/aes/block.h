@@ -43,8 +43,16 @@ static inline AES_Block aes_xor_blocks(AES_Block a, AES_Block b) {
     return _mm_xor_si128(a, b);
 }
 
+static inline AES_Block aes_reverse_byte_order(AES_Block block) {
+    return _mm_shuffle_epi8(block, aes_make_block(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f));
+}
+
+/* Increments the last 4 bytes of a block as a big-endian number. */
 AES_Block aes_inc_block(AES_Block x);
 
+/* Multiplies a block by x in GF(2^128) (the "doubling" used in CMAC & OCB). */
+AES_Block aes_double_block(AES_Block x);
+
 typedef struct {
     char str[33];
 } AES_BlockString;
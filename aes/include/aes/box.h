@@ -10,14 +10,104 @@
 #include "algorithm.h"
 #include "block.h"
 #include "error.h"
+#include "ghash.h"
 #include "mode.h"
 
+#include <assert.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* The GCM state.
+ * j0 is the initial counter block, computed from the first 12 bytes of the
+ * init vector (the last 4 bytes are ignored).
+ * hash is the GHASH of the additional authenticated data (and then of the
+ * ciphertext, while a message is being processed). */
+typedef struct {
+    AES_GhashKey key;
+    const AES_GhashOps* ops;
+    AES_Block j0;
+    AES_Block hash;
+    size_t aad_size;
+} AES_BoxGcm;
+
+/* The XTS state: the round keys for the second key, which encrypts the
+ * tweaks.
+ * tweak is the tweak of the next block, while a data unit is processed in
+ * chunks or from several segments. */
+typedef struct {
+    AES_EncryptionRoundKeys tweak_keys;
+    AES_Block tweak;
+} AES_BoxXts;
+
+/* The CCM state.
+ * a0 is the counter block 0, computed from the first nonce_size bytes of the
+ * init vector.
+ * The first block of the MAC depends on the message size, so the additional
+ * authenticated data can't be processed before the message is, and only the
+ * pointer to it is stored.
+ * mac is the CBC-MAC value, while a message is being processed. */
+typedef struct {
+    size_t nonce_size;
+    size_t tag_size;
+    AES_Block a0;
+    const void* aad;
+    size_t aad_size;
+    AES_Block mac;
+} AES_BoxCcm;
+
+/* The number of L_i values computed in advance, which limits the number of
+ * blocks in an OCB message to 2^32 - 1. */
+#define AES_BOX_OCB_NUMOF_L 32
+
+/* The OCB state.
+ * l_star, l_dollar & l are the values of L_*, L_$ & L_i, l_sums[j] is
+ * L_ntz(1) ^ ... ^ L_ntz(j + 1), so that the offsets of 8 consecutive blocks
+ * can be computed independently of each other.
+ * offset0 is computed from the first 12 bytes of the init vector.
+ * hash is the hash of the additional authenticated data.
+ * offset, checksum & index are only used while a message is being
+ * processed. */
+typedef struct {
+    AES_Block l_star;
+    AES_Block l_dollar;
+    AES_Block l[AES_BOX_OCB_NUMOF_L];
+    AES_Block l_sums[7];
+    AES_Block offset0;
+    AES_Block hash;
+    AES_Block offset;
+    AES_Block checksum;
+    unsigned long long index;
+} AES_BoxOcb;
+
+/* The GCM-SIV state.
+ * The POLYVAL key & the encryption keys are derived from the key-generating
+ * key & the nonce (the first 12 bytes of the init vector) for every message.
+ * Like in CCM, the additional authenticated data is only processed along with
+ * the message. */
+typedef struct {
+    const AES_GhashOps* ops;
+    AES_GhashKey key;
+    AES_EncryptionRoundKeys encryption_keys;
+    AES_Block counter;
+    const void* aad;
+    size_t aad_size;
+} AES_BoxGcmSiv;
+
+/* The state of a message processed in chunks (see aes_box_encrypt_update).
+ * buffer holds the input that couldn't be processed yet: the last partial
+ * block, and on decryption, the last block if it's padded or the tag (in XTS
+ * mode, the last complete block, which a partial block might steal from).
+ * message_size is the number of bytes processed so far. */
+typedef struct {
+    AES_Block buffer[2];
+    size_t buffer_size;
+    unsigned long long message_size;
+    int started;
+} AES_BoxStream;
+
 typedef struct {
     AES_Algorithm algorithm;
     AES_Mode mode;
@@ -25,8 +115,28 @@ typedef struct {
     AES_EncryptionRoundKeys encryption_keys;
     AES_DecryptionRoundKeys decryption_keys;
     const AES_Ops* ops;
+    /* Only the state of the box's mode is valid. */
+    union {
+        AES_BoxGcm gcm;
+        AES_BoxXts xts;
+        AES_BoxCcm ccm;
+        AES_BoxOcb ocb;
+        AES_BoxGcmSiv gcm_siv;
+    };
+    AES_BoxStream stream;
+    AES_Block tag;
 } AES_Box;
 
+/* The size of the tag appended to the ciphertext in authenticated modes (by
+ * default in CCM mode).
+ * GCM, OCB (RFC 7253) & GCM-SIV (RFC 8452) use the first 12 bytes of the init
+ * vector as the nonce.
+ * GCM-SIV only supports AES-128 & AES-256. */
+#define AES_BOX_TAG_SIZE 16
+
+/* The default CCM nonce size. */
+#define AES_BOX_CCM_NONCE_SIZE 12
+
 AES_StatusCode aes_box_init(
     AES_Box* box,
     AES_Algorithm algorithm,
@@ -36,6 +146,42 @@ AES_StatusCode aes_box_init(
     AES_ErrorDetails* err_details
 );
 
+/* XTS (IEEE 1619) requires two keys: box_key encrypts the data, tweak_key
+ * encrypts the tweaks.
+ * XTS is only defined for AES-128 & AES-256.
+ * Every call to aes_box_encrypt_buffer or aes_box_decrypt_buffer processes a
+ * single data unit (of at least one block), the tweak being the init vector
+ * (which can be NULL if only the sector functions are used). */
+AES_StatusCode aes_box_init_xts(
+    AES_Box* box,
+    AES_Algorithm algorithm,
+    const AES_Key* box_key,
+    const AES_Key* tweak_key,
+    const AES_Block* iv,
+    AES_ErrorDetails* err_details
+);
+
+/* CCM (NIST SP 800-38C) uses the first nonce_size bytes of the init vector
+ * as the nonce (7 to 13 bytes) & appends a tag of tag_size bytes (4 to 16,
+ * even).
+ * aes_box_init uses a 12-byte nonce & a 16-byte tag.
+ * A shorter nonce allows for longer messages: up to 2^(8 * (15 - nonce_size))
+ * bytes. */
+AES_StatusCode aes_box_init_ccm(
+    AES_Box* box,
+    AES_Algorithm algorithm,
+    const AES_Key* box_key,
+    const AES_Block* iv,
+    size_t nonce_size,
+    size_t tag_size,
+    AES_ErrorDetails* err_details
+);
+
+/* Sets the init vector (the nonce in authenticated modes, the tweak in XTS
+ * mode) for the next message, without expanding the key again.
+ * In CCM mode, call it before aes_box_set_aad. */
+AES_StatusCode aes_box_set_iv(AES_Box* box, const AES_Block* iv, AES_ErrorDetails* err_details);
+
 AES_StatusCode aes_box_encrypt_block(
     AES_Box* box,
     const AES_Block* plaintext,
@@ -50,6 +196,119 @@ AES_StatusCode aes_box_decrypt_block(
     AES_ErrorDetails* err_details
 );
 
+/* The same as aes_box_encrypt_block/aes_box_decrypt_block, without any checks
+ * or error reporting, for the callers that have checked the arguments already:
+ * the pointers mustn't be NULL, and the mode mustn't be an authenticated one
+ * (see aes_mode_is_authenticated).
+ * They're inline, so that a single block only costs the mode switch & a call
+ * through box->ops->unchecked. */
+
+static inline void aes_box_encrypt_block_unchecked(
+    AES_Box* box,
+    const AES_Block* plaintext,
+    AES_Block* ciphertext
+) {
+    const AES_UncheckedOps* ops = box->ops->unchecked;
+    const AES_EncryptionRoundKeys* keys = &box->encryption_keys;
+
+    switch (box->mode) {
+        case AES_ECB:
+            *ciphertext = ops->encrypt_block(*plaintext, keys);
+            break;
+
+        case AES_CBC:
+            box->iv = ops->encrypt_block(aes_xor_blocks(*plaintext, box->iv), keys);
+            *ciphertext = box->iv;
+            break;
+
+        case AES_CFB:
+            box->iv = aes_xor_blocks(ops->encrypt_block(box->iv, keys), *plaintext);
+            *ciphertext = box->iv;
+            break;
+
+        case AES_OFB:
+            box->iv = ops->encrypt_block(box->iv, keys);
+            *ciphertext = aes_xor_blocks(box->iv, *plaintext);
+            break;
+
+        case AES_CTR:
+            *ciphertext = aes_xor_blocks(ops->encrypt_block(box->iv, keys), *plaintext);
+            box->iv = aes_inc_block(box->iv);
+            break;
+
+        case AES_XTS: {
+            /* A single block is a complete XTS data unit. */
+            const AES_Block tweak = ops->encrypt_block(box->iv, &box->xts.tweak_keys);
+            const AES_Block block = ops->encrypt_block(aes_xor_blocks(*plaintext, tweak), keys);
+            *ciphertext = aes_xor_blocks(block, tweak);
+            break;
+        }
+
+        default:
+            assert(0);
+            break;
+    }
+}
+
+static inline void aes_box_decrypt_block_unchecked(
+    AES_Box* box,
+    const AES_Block* ciphertext,
+    AES_Block* plaintext
+) {
+    const AES_UncheckedOps* ops = box->ops->unchecked;
+    const AES_Block input = *ciphertext;
+
+    switch (box->mode) {
+        case AES_ECB:
+            *plaintext = ops->decrypt_block(input, &box->decryption_keys);
+            break;
+
+        case AES_CBC:
+            *plaintext =
+                aes_xor_blocks(ops->decrypt_block(input, &box->decryption_keys), box->iv);
+            box->iv = input;
+            break;
+
+        case AES_CFB:
+            *plaintext = aes_xor_blocks(ops->encrypt_block(box->iv, &box->encryption_keys), input);
+            box->iv = input;
+            break;
+
+        case AES_XTS: {
+            const AES_Block tweak = ops->encrypt_block(box->iv, &box->xts.tweak_keys);
+            const AES_Block block =
+                ops->decrypt_block(aes_xor_blocks(input, tweak), &box->decryption_keys);
+            *plaintext = aes_xor_blocks(block, tweak);
+            break;
+        }
+
+        default:
+            /* OFB & CTR decryption is the same as encryption. */
+            aes_box_encrypt_block_unchecked(box, ciphertext, plaintext);
+            break;
+    }
+}
+
+/* The size of the ciphertext of a src_size-byte message (including the padding
+ * or the tag), and the size of the plaintext of a src_size-byte ciphertext.
+ * The padding is only known after decryption, so in ECB & CBC modes the
+ * plaintext might be up to a block shorter.
+ * These return the same errors as aes_box_encrypt_buffer/aes_box_decrypt_buffer
+ * would for a message of that size. */
+AES_StatusCode aes_box_encrypted_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_max_decrypted_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
 AES_StatusCode aes_box_encrypt_buffer(
     AES_Box* box,
     const void* src,
@@ -68,6 +327,189 @@ AES_StatusCode aes_box_decrypt_buffer(
     AES_ErrorDetails* err_details
 );
 
+/* src & dest can point to the same buffer (but mustn't overlap otherwise), in
+ * every mode.
+ * The in-place functions encrypt or decrypt src_size bytes at buf, which must
+ * be large enough to hold the ciphertext (see aes_box_encrypted_size), and set
+ * *dest_size. */
+
+AES_StatusCode aes_box_encrypt_inplace(
+    AES_Box* box,
+    void* buf,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_decrypt_inplace(
+    AES_Box* box,
+    void* buf,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+/* In authenticated modes, every call to aes_box_encrypt_buffer or
+ * aes_box_decrypt_buffer processes a complete message.
+ * The ciphertext is followed by the tag, which is checked on decryption
+ * (AES_AUTHENTICATION_ERROR is returned & the plaintext is zeroed out if it
+ * doesn't match).
+ * Never encrypt two messages using the same key & init vector, initialize a
+ * new box instead. */
+
+/* Sets the additional authenticated data for the next message.
+ * It's not encrypted, but the tag depends on it, so it must be the same on
+ * decryption.
+ * In CCM & GCM-SIV modes, it's only processed along with the message, so the
+ * buffer must stay valid until then.
+ * It can't be set in the middle of a message processed in chunks. */
+AES_StatusCode aes_box_set_aad(
+    AES_Box* box,
+    const void* aad,
+    size_t aad_size,
+    AES_ErrorDetails* err_details
+);
+
+/* The tag of the last message encrypted or successfully decrypted.
+ * In CCM mode, only the first tag_size bytes are set, the rest are zero. */
+AES_StatusCode aes_box_get_tag(const AES_Box* box, AES_Block* tag, AES_ErrorDetails* err_details);
+
+/* Process a message in chunks of any size, which produces the same result as
+ * aes_box_encrypt_buffer/aes_box_decrypt_buffer would have for the whole
+ * message.
+ * The first call to aes_box_encrypt_update/aes_box_decrypt_update starts a
+ * new message, aes_box_encrypt_finalize/aes_box_decrypt_finalize completes it
+ * (adds or strips the padding, appends or checks the tag).
+ * Not every chunk can be processed right away, so an update call writes a
+ * whole number of blocks, at most src_size + 15 bytes, and a finalize call
+ * writes at most AES_BOX_FINALIZE_MAX_SIZE bytes.
+ * *written is set to the number of bytes written.
+ * Part of the input might only be written out by a later call, so src & dest
+ * mustn't overlap.
+ * Setting the init vector abandons the current message.
+ * Not supported in CCM & GCM-SIV modes (see aes_mode_supports_streaming).
+ * In authenticated modes, the plaintext is written before the tag is checked,
+ * so don't use it until aes_box_decrypt_finalize succeeds (only the plaintext
+ * it writes itself is zeroed out otherwise). */
+#define AES_BOX_FINALIZE_MAX_SIZE 32
+
+AES_StatusCode aes_box_encrypt_update(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_encrypt_finalize(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_decrypt_update(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_decrypt_finalize(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+);
+
+/* A segment of a message scattered across memory. */
+typedef struct {
+    void* base;
+    size_t size;
+} AES_IoVec;
+
+/* Process a message made of numof_src segments, which produces the same
+ * result as aes_box_encrypt_buffer/aes_box_decrypt_buffer would have for the
+ * segments concatenated, and write it to numof_dest segments, filling them in
+ * order.
+ * *dest_size is set to the number of bytes written.
+ * AES_BUFFER_TOO_SMALL_ERROR is returned if the destination segments can't
+ * hold the ciphertext (see aes_box_encrypted_size) or the plaintext (see
+ * aes_box_max_decrypted_size).
+ * Only the blocks that span several segments are copied.
+ * dest can start with the same segments as src (with extra segments for the
+ * padding or the tag, when encrypting), but they mustn't overlap otherwise. */
+AES_StatusCode aes_box_encrypt_iov(
+    AES_Box* box,
+    const AES_IoVec* src,
+    size_t numof_src,
+    const AES_IoVec* dest,
+    size_t numof_dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_decrypt_iov(
+    AES_Box* box,
+    const AES_IoVec* src,
+    size_t numof_src,
+    const AES_IoVec* dest,
+    size_t numof_dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+/* In XTS mode, processes numof_sectors consecutive data units of sector_size
+ * bytes each (at least one block).
+ * The tweak of a sector is its number (as a 128-bit little-endian number),
+ * the first one being first_sector.
+ * Short sectors are processed several at a time, unless they end with a
+ * partial block: those are processed one at a time, which is slower.
+ * src & dest can point to the same buffer. */
+AES_StatusCode aes_box_encrypt_sectors(
+    AES_Box* box,
+    const void* src,
+    size_t sector_size,
+    size_t numof_sectors,
+    unsigned long long first_sector,
+    void* dest,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_box_decrypt_sectors(
+    AES_Box* box,
+    const void* src,
+    size_t sector_size,
+    size_t numof_sectors,
+    unsigned long long first_sector,
+    void* dest,
+    AES_ErrorDetails* err_details
+);
+
+/* In OFB and CTR modes, the keystream doesn't depend on the data, so it can be
+ * computed in advance.
+ * Every call consumes a whole number of keystream blocks, so keep dest_size a
+ * multiple of the block size to continue the keystream in the next call.
+ * Then aes_apply_keystream produces the same result as
+ * aes_box_encrypt_buffer/aes_box_decrypt_buffer would have. */
+AES_StatusCode aes_box_generate_keystream(
+    AES_Box* box,
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_apply_keystream(
+    const void* src,
+    size_t src_size,
+    const void* keystream,
+    void* dest,
+    AES_ErrorDetails* err_details
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "algorithm.h"
+#include "block.h"
+#include "error.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CMAC (NIST SP 800-38B, RFC 4493).
+ * The subkeys K1 & K2 are derived once, when the key is set, so a single
+ * AES_Cmac can be used to compute any number of MACs. */
+typedef struct {
+    AES_Algorithm algorithm;
+    const AES_Ops* ops;
+    AES_EncryptionRoundKeys encryption_keys;
+    AES_Block k1;
+    AES_Block k2;
+} AES_Cmac;
+
+/* The number of messages processed together by aes_cmac_compute_batch. */
+#define AES_CMAC_BATCH_LEN 32
+
+AES_StatusCode aes_cmac_init(
+    AES_Cmac* cmac,
+    AES_Algorithm algorithm,
+    const AES_Key* key,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_cmac_compute(
+    const AES_Cmac* cmac,
+    const void* src,
+    size_t src_size,
+    AES_Block* mac,
+    AES_ErrorDetails* err_details
+);
+
+/* Computes the MACs of numof_messages independent messages, the i-th one
+ * being src_sizes[i] bytes at srcs[i].
+ * A single message is a serial chain of block encryptions, so the chains of
+ * up to AES_CMAC_BATCH_LEN messages are advanced together instead, one block
+ * of every message per encrypt_blocks call.
+ * This is much faster than computing the MACs one by one if the messages are
+ * short & have similar sizes. */
+AES_StatusCode aes_cmac_compute_batch(
+    const AES_Cmac* cmac,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_messages,
+    AES_Block* macs,
+    AES_ErrorDetails* err_details
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "algorithm.h"
+#include "block.h"
+#include "error.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CTR_DRBG (NIST SP 800-90A), with a 128-bit counter.
+ * seedlen is the key size plus 16 bytes: 32 bytes for AES-128, 40 bytes for
+ * AES-192 & 48 bytes for AES-256.
+ * An instance has no global state & takes no locks, so use an instance per
+ * thread (or see aes_ctr_drbg_generate_thread_local). */
+typedef struct {
+    AES_Algorithm algorithm;
+    const AES_Ops* ops;
+    int use_df;
+    AES_EncryptionRoundKeys df_keys;
+    AES_EncryptionRoundKeys encryption_keys;
+    AES_Block v;
+    unsigned long long reseed_counter;
+    unsigned long long reseed_interval;
+} AES_CtrDrbg;
+
+/* The maximum number of requests between reseeds.
+ * reseed_interval is set to this by aes_ctr_drbg_init, it can be lowered
+ * afterwards. */
+#define AES_CTR_DRBG_MAX_RESEED_INTERVAL (1ull << 48)
+
+/* Requests for more bytes than this are split into several requests. */
+#define AES_CTR_DRBG_MAX_REQUEST_SIZE (1 << 16)
+
+/* Without the derivation function (use_df == 0), the entropy input must be
+ * exactly seedlen bytes of full entropy, the nonce is not used, and the
+ * personalization string & the additional input must be at most seedlen bytes
+ * long.
+ * With the derivation function, the entropy input must be at least as long as
+ * the key, the other inputs can be of any size. */
+AES_StatusCode aes_ctr_drbg_init(
+    AES_CtrDrbg* drbg,
+    AES_Algorithm algorithm,
+    int use_df,
+    const void* entropy,
+    size_t entropy_size,
+    const void* nonce,
+    size_t nonce_size,
+    const void* personalization,
+    size_t personalization_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_ctr_drbg_reseed(
+    AES_CtrDrbg* drbg,
+    const void* entropy,
+    size_t entropy_size,
+    const void* additional,
+    size_t additional_size,
+    AES_ErrorDetails* err_details
+);
+
+/* The additional input only goes into the first request if dest_size is
+ * larger than AES_CTR_DRBG_MAX_REQUEST_SIZE.
+ * AES_RESEED_REQUIRED_ERROR is returned once reseed_interval requests have
+ * been made since the last reseed. */
+AES_StatusCode aes_ctr_drbg_generate(
+    AES_CtrDrbg* drbg,
+    void* dest,
+    size_t dest_size,
+    const void* additional,
+    size_t additional_size,
+    AES_ErrorDetails* err_details
+);
+
+/* Uses the calling thread's own instance (AES-256 with the derivation
+ * function), which is instantiated & periodically reseeded using the
+ * operating system's entropy source.
+ * It's also reseeded in a child process after fork(), so that the child
+ * doesn't return the same bytes as the parent. */
+AES_StatusCode aes_ctr_drbg_generate_thread_local(
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,6 +22,10 @@ typedef enum {
     AES_MISSING_PADDING_ERROR,
     AES_MEMORY_ALLOCATION_ERROR,
     AES_MODE_REQUIRES_INIT_VECTOR_ERROR,
+    AES_AUTHENTICATION_ERROR,
+    AES_RESEED_REQUIRED_ERROR,
+    AES_ENTROPY_SOURCE_ERROR,
+    AES_BUFFER_TOO_SMALL_ERROR,
     AesErrorCount,
 } AES_StatusCode;
 
@@ -33,6 +37,12 @@ const char* aes_strerror(AES_StatusCode ec);
 
 #define AES_MAX_CALL_STACK_LENGTH 32
 
+/* Every function reports its status code, and, optionally, the details of the
+ * error: the parameters & the call stack (captured on Windows only).
+ * Passing NULL instead of AES_ErrorDetails* is the compact mode: nothing is
+ * formatted or captured, and the status code is all there is.
+ * A failing function can be called again with AES_ErrorDetails* to get the
+ * details, if it doesn't have side effects (like the block functions). */
 typedef struct {
     AES_StatusCode ec; ///< Error code
 
@@ -75,6 +85,14 @@ AES_StatusCode aes_error_memory_allocation(AES_ErrorDetails* err_details);
 
 AES_StatusCode aes_error_mode_requires_init_vector(AES_ErrorDetails* err_details);
 
+AES_StatusCode aes_error_authentication(AES_ErrorDetails* err_details);
+
+AES_StatusCode aes_error_reseed_required(AES_ErrorDetails* err_details);
+
+AES_StatusCode aes_error_entropy_source(AES_ErrorDetails* err_details);
+
+AES_StatusCode aes_error_buffer_too_small(AES_ErrorDetails* err_details);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "impl.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* GHASH, the hash function behind GCM (see NIST SP 800-38D). */
+
+/* The number of powers of the hash subkey H computed in advance.
+ * This many blocks are hashed with a single reduction. */
+#define AES_GHASH_NUMOF_POWERS 8
+
+typedef struct {
+    AES_Block powers[AES_GHASH_NUMOF_POWERS];
+} AES_GhashKey;
+
+/* The hash subkey is H = E(0).
+ * The hash value & the blocks are in their natural byte order, the key is in
+ * whatever format the implementation prefers. */
+
+typedef void (*AES_GhashInitKey)(AES_GhashKey* key, AES_Block h);
+
+typedef AES_Block (*AES_Ghash)(
+    AES_Block hash,
+    const void* src,
+    size_t numof_blocks,
+    const AES_GhashKey* key
+);
+
+typedef struct {
+    AES_GhashInitKey init_key;
+    AES_Ghash ghash;
+} AES_GhashOps;
+
+/* The AES-NI implementations use PCLMULQDQ, the others use the portable
+ * version. */
+const AES_GhashOps* aes_get_impl_ghash_ops(AES_Implementation);
+
+void aes_ghash_init_key_clmul(AES_GhashKey* key, AES_Block h);
+
+AES_Block aes_ghash_clmul(
+    AES_Block hash,
+    const void* src,
+    size_t numof_blocks,
+    const AES_GhashKey* key
+);
+
+/* Unlike the portable AES implementation, this one is constant-time (and
+ * slow). */
+
+void aes_ghash_init_key_portable(AES_GhashKey* key, AES_Block h);
+
+AES_Block aes_ghash_portable(
+    AES_Block hash,
+    const void* src,
+    size_t numof_blocks,
+    const AES_GhashKey* key
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "algorithm.h"
+#include "error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    AES_IMPL_PORTABLE,
+    AES_IMPL_AESNI,
+    AES_IMPL_VPERM,
+    AES_IMPL_VAES,
+    AES_IMPL_VAES512,
+    AesImplCount,
+} AES_Implementation;
+
+/* Whether the implementation can run on this CPU. */
+int aes_is_impl_supported(AES_Implementation);
+
+/* The name accepted by the AES_TOOLS_IMPL environment variable. */
+const char* aes_get_impl_name(AES_Implementation);
+
+/* The implementation behind aes_get_ops (and, therefore, AES_Box).
+ * It's selected on first use: if the AES_TOOLS_IMPL environment variable names
+ * an implementation this CPU supports, it's used; otherwise, the fastest
+ * supported implementation is. */
+AES_Implementation aes_get_impl(void);
+
+/* Overrides the selection above, for benchmarking & testing.
+ * Boxes initialized before the call keep using the old implementation.
+ * Call it before the library is used by other threads: it's not a data race,
+ * but a box initialized concurrently with the call might get either one. */
+AES_StatusCode aes_set_impl(AES_Implementation, AES_ErrorDetails*);
+
+const AES_Ops* aes_get_impl_ops(AES_Implementation, AES_Algorithm);
+
+#ifdef __cplusplus
+}
+#endif
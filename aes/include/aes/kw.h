@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "algorithm.h"
+#include "block.h"
+#include "error.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Key wrap: KW (RFC 3394) & KWP, KW with padding (RFC 5649).
+ * The key-encryption key is expanded once, so a single AES_Kw can be used to
+ * wrap & unwrap any number of keys. */
+typedef struct {
+    AES_Algorithm algorithm;
+    const AES_Ops* ops;
+    AES_EncryptionRoundKeys encryption_keys;
+    AES_DecryptionRoundKeys decryption_keys;
+} AES_Kw;
+
+/* The number of keys processed together by the batch functions. */
+#define AES_KW_BATCH_LEN 32
+
+AES_StatusCode aes_kw_init(
+    AES_Kw* kw,
+    AES_Algorithm algorithm,
+    const AES_Key* kek,
+    AES_ErrorDetails* err_details
+);
+
+/* In KW mode, the key must be a multiple of 8 bytes, at least 16 bytes long.
+ * In KWP mode, it's zero-padded to a multiple of 8 bytes, so it can be of any
+ * (non-zero) size.
+ * The wrapped key is 8 bytes longer than the (padded) key.
+ * Like aes_box_encrypt_buffer/aes_box_decrypt_buffer, these only set
+ * *dest_size & return if dest is NULL.
+ * The unwrapped key is at most src_size - 8 bytes long (exactly that in KW
+ * mode).
+ * If the integrity check fails, AES_AUTHENTICATION_ERROR is returned & dest is
+ * zeroed out. */
+
+AES_StatusCode aes_kw_wrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kw_unwrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kwp_wrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kwp_unwrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+);
+
+/* Wrap or unwrap numof_keys independent keys, the i-th one being src_sizes[i]
+ * bytes at srcs[i], the result being dest_sizes[i] bytes at dests[i].
+ * The wrapping of a single key is a serial chain of 6n block encryptions, so
+ * the chains of up to AES_KW_BATCH_LEN keys are advanced together instead, one
+ * block of every key per encrypt_blocks/decrypt_blocks call.
+ * On unwrapping, dest_sizes[i] is set to 0 for every key that fails the
+ * integrity check (or has an invalid size), and AES_AUTHENTICATION_ERROR is
+ * returned after all the other keys are unwrapped. */
+
+AES_StatusCode aes_kw_wrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kw_unwrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kwp_wrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+);
+
+AES_StatusCode aes_kwp_unwrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,12 +19,37 @@ typedef enum {
     AES_CFB,
     AES_OFB,
     AES_CTR,
+    AES_GCM,
+    AES_XTS,
+    AES_CCM,
+    AES_OCB,
+    AES_GCM_SIV,
 } AES_Mode;
 
 static inline int aes_mode_requires_init_vector(AES_Mode mode) {
     return mode != AES_ECB;
 }
 
+/* Authenticated modes append a tag to the ciphertext & check it on
+ * decryption. */
+static inline int aes_mode_is_authenticated(AES_Mode mode) {
+    switch (mode) {
+        case AES_GCM:
+        case AES_CCM:
+        case AES_OCB:
+        case AES_GCM_SIV:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* CCM needs the message size before the message, and GCM-SIV needs two
+ * passes over the plaintext, so a message can't be processed in chunks. */
+static inline int aes_mode_supports_streaming(AES_Mode mode) {
+    return mode != AES_CCM && mode != AES_GCM_SIV;
+}
+
 #ifdef __cplusplus
 }
 #endif
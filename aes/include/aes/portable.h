@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "round_keys.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The table-driven implementation, used on CPUs without AES-NI.
+ * The round keys are compatible with the ones produced by the AES-NI
+ * implementation.
+ * It's NOT constant-time: the table lookups leak the key & the data through
+ * the cache. */
+
+AES_Block
+aes128_encrypt_block_portable(AES_Block plaintext, const AES128_RoundKeys* encryption_keys);
+AES_Block
+aes192_encrypt_block_portable(AES_Block plaintext, const AES192_RoundKeys* encryption_keys);
+AES_Block
+aes256_encrypt_block_portable(AES_Block plaintext, const AES256_RoundKeys* encryption_keys);
+
+AES_Block
+aes128_decrypt_block_portable(AES_Block ciphertext, const AES128_RoundKeys* decryption_keys);
+AES_Block
+aes192_decrypt_block_portable(AES_Block ciphertext, const AES192_RoundKeys* decryption_keys);
+AES_Block
+aes256_decrypt_block_portable(AES_Block ciphertext, const AES256_RoundKeys* decryption_keys);
+
+void aes128_encrypt_blocks_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_blocks_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_blocks_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_decrypt_blocks_portable(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+);
+void aes192_decrypt_blocks_portable(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+);
+void aes256_decrypt_blocks_portable(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+);
+
+void aes128_encrypt_pair_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_pair_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_pair_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_cbc_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_cbc_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_cbc_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_cfb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_cfb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_cfb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_ofb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_ofb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_ofb_portable(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_expand_key_portable(AES_Block key, AES128_RoundKeys* encryption_keys);
+void
+aes192_expand_key_portable(AES_Block key_lo, AES_Block key_hi, AES192_RoundKeys* encryption_keys);
+void
+aes256_expand_key_portable(AES_Block key_lo, AES_Block key_hi, AES256_RoundKeys* encryption_keys);
+
+void aes128_derive_decryption_keys_portable(
+    const AES128_RoundKeys* encryption_keys,
+    AES128_RoundKeys* decryption_keys
+);
+void aes192_derive_decryption_keys_portable(
+    const AES192_RoundKeys* encryption_keys,
+    AES192_RoundKeys* decryption_keys
+);
+void aes256_derive_decryption_keys_portable(
+    const AES256_RoundKeys* encryption_keys,
+    AES256_RoundKeys* decryption_keys
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "round_keys.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The multi-block functions using VAES, on top of the AES-NI implementation.
+ * The round keys are the same as for the AES-NI implementation.
+ * The *_vaes versions require AVX2, the *_vaes512 versions require
+ * AVX-512F. */
+
+void aes128_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+);
+void aes192_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+);
+void aes256_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+);
+
+void aes128_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+);
+void aes192_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+);
+void aes256_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include "block.h"
+#include "round_keys.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The constant-time implementation for CPUs without AES-NI, using SSSE3.
+ * The round keys are kept in a different basis, so they're NOT compatible
+ * with the other implementations.
+ * The decryption keys are scheduled from the key directly. */
+
+AES_Block
+aes128_encrypt_block_vperm(AES_Block plaintext, const AES128_RoundKeys* encryption_keys);
+AES_Block
+aes192_encrypt_block_vperm(AES_Block plaintext, const AES192_RoundKeys* encryption_keys);
+AES_Block
+aes256_encrypt_block_vperm(AES_Block plaintext, const AES256_RoundKeys* encryption_keys);
+
+AES_Block
+aes128_decrypt_block_vperm(AES_Block ciphertext, const AES128_RoundKeys* decryption_keys);
+AES_Block
+aes192_decrypt_block_vperm(AES_Block ciphertext, const AES192_RoundKeys* decryption_keys);
+AES_Block
+aes256_decrypt_block_vperm(AES_Block ciphertext, const AES256_RoundKeys* decryption_keys);
+
+void aes128_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+);
+void aes192_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+);
+void aes256_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+);
+
+void aes128_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+);
+void aes192_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+);
+void aes256_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+);
+
+void aes128_expand_key_vperm(
+    AES_Block key,
+    AES128_RoundKeys* encryption_keys,
+    AES128_RoundKeys* decryption_keys
+);
+void aes192_expand_key_vperm(
+    AES_Block key_lo,
+    AES_Block key_hi,
+    AES192_RoundKeys* encryption_keys,
+    AES192_RoundKeys* decryption_keys
+);
+void aes256_expand_key_vperm(
+    AES_Block key_lo,
+    AES_Block key_hi,
+    AES256_RoundKeys* encryption_keys,
+    AES256_RoundKeys* decryption_keys
+);
+
+#ifdef __cplusplus
+}
+#endif
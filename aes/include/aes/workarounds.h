@@ -15,6 +15,12 @@
 #warning "couldn't determine alignment attribute"
 #endif
 
+#if defined(_MSC_VER)
+#define AES_THREAD_LOCAL __declspec(thread)
+#else
+#define AES_THREAD_LOCAL _Thread_local
+#endif
+
 #define AES_UNUSED_PARAMETER(...) (void)(__VA_ARGS__)
 
 /* Targetting 32-bit Windows, match the existing ASM implementation's behavior
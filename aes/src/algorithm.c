@@ -88,15 +88,12 @@ static AES_StatusCode aes_format_key_aes256(
 static AES_StatusCode check_expand_key_params(
     const AES_Key* key,
     AES_EncryptionRoundKeys* encryption_keys,
-    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
     if (key == NULL)
         return aes_error_null_argument(err_details, "key");
     if (encryption_keys == NULL)
         return aes_error_null_argument(err_details, "encryption_keys");
-    if (decryption_keys == NULL)
-        return aes_error_null_argument(err_details, "decryption_keys");
     return AES_SUCCESS;
 }
 
@@ -106,15 +103,15 @@ static AES_StatusCode aes_expand_key_aes128(
     AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status =
-        check_expand_key_params(key, encryption_keys, decryption_keys, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
     aes128_expand_key(&key->aes128_key, &encryption_keys->aes128_enc_keys);
-    aes128_derive_decryption_keys(
-        &encryption_keys->aes128_enc_keys, &decryption_keys->aes128_dec_keys
-    );
+    if (decryption_keys != NULL)
+        aes128_derive_decryption_keys(
+            &encryption_keys->aes128_enc_keys, &decryption_keys->aes128_dec_keys
+        );
     return status;
 }
 
@@ -124,15 +121,15 @@ static AES_StatusCode aes_expand_key_aes192(
     AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status =
-        check_expand_key_params(key, encryption_keys, decryption_keys, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
     aes192_expand_key(&key->aes192_key, &encryption_keys->aes192_enc_keys);
-    aes192_derive_decryption_keys(
-        &encryption_keys->aes192_enc_keys, &decryption_keys->aes192_dec_keys
-    );
+    if (decryption_keys != NULL)
+        aes192_derive_decryption_keys(
+            &encryption_keys->aes192_enc_keys, &decryption_keys->aes192_dec_keys
+        );
     return status;
 }
 
@@ -142,172 +139,419 @@ static AES_StatusCode aes_expand_key_aes256(
     AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status =
-        check_expand_key_params(key, encryption_keys, decryption_keys, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
     aes256_expand_key(&key->aes256_key, &encryption_keys->aes256_enc_keys);
-    aes256_derive_decryption_keys(
-        &encryption_keys->aes256_enc_keys, &decryption_keys->aes256_dec_keys
-    );
+    if (decryption_keys != NULL)
+        aes256_derive_decryption_keys(
+            &encryption_keys->aes256_enc_keys, &decryption_keys->aes256_dec_keys
+        );
     return status;
 }
 
-static AES_StatusCode check_encrypt_params(
-    const AES_Block* input,
-    const AES_EncryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes128_portable(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    if (input == NULL)
-        return aes_error_null_argument(err_details, "input");
-    if (params == NULL)
-        return aes_error_null_argument(err_details, "params");
-    if (output == NULL)
-        return aes_error_null_argument(err_details, "output");
-    return AES_SUCCESS;
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes128_expand_key_portable(key->aes128_key.key, &encryption_keys->aes128_enc_keys);
+    if (decryption_keys != NULL)
+        aes128_derive_decryption_keys_portable(
+            &encryption_keys->aes128_enc_keys, &decryption_keys->aes128_dec_keys
+        );
+    return status;
 }
 
-static AES_StatusCode check_decrypt_params(
-    const AES_Block* input,
-    const AES_DecryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes192_portable(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    if (input == NULL)
-        return aes_error_null_argument(err_details, "input");
-    if (params == NULL)
-        return aes_error_null_argument(err_details, "params");
-    if (output == NULL)
-        return aes_error_null_argument(err_details, "output");
-    return AES_SUCCESS;
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes192_expand_key_portable(
+        key->aes192_key.lo, key->aes192_key.hi, &encryption_keys->aes192_enc_keys
+    );
+    if (decryption_keys != NULL)
+        aes192_derive_decryption_keys_portable(
+            &encryption_keys->aes192_enc_keys, &decryption_keys->aes192_dec_keys
+        );
+    return status;
 }
 
-static AES_StatusCode aes_encrypt_block_aes128(
-    const AES_Block* input,
-    const AES_EncryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes256_portable(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_encrypt_params(input, params, output, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes128_encrypt_block(*input, &params->aes128_enc_keys);
+    aes256_expand_key_portable(
+        key->aes256_key.lo, key->aes256_key.hi, &encryption_keys->aes256_enc_keys
+    );
+    if (decryption_keys != NULL)
+        aes256_derive_decryption_keys_portable(
+            &encryption_keys->aes256_enc_keys, &decryption_keys->aes256_dec_keys
+        );
     return status;
 }
 
-static AES_StatusCode aes_decrypt_block_aes128(
-    const AES_Block* input,
-    const AES_DecryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes128_vperm(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_decrypt_params(input, params, output, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes128_decrypt_block(*input, &params->aes128_dec_keys);
+    aes128_expand_key_vperm(
+        key->aes128_key.key,
+        &encryption_keys->aes128_enc_keys,
+        decryption_keys ? &decryption_keys->aes128_dec_keys : NULL
+    );
     return status;
 }
 
-static AES_StatusCode aes_encrypt_block_aes192(
-    const AES_Block* input,
-    const AES_EncryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes192_vperm(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_encrypt_params(input, params, output, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes192_encrypt_block(*input, &params->aes192_enc_keys);
+    aes192_expand_key_vperm(
+        key->aes192_key.lo,
+        key->aes192_key.hi,
+        &encryption_keys->aes192_enc_keys,
+        decryption_keys ? &decryption_keys->aes192_dec_keys : NULL
+    );
     return status;
 }
 
-static AES_StatusCode aes_decrypt_block_aes192(
-    const AES_Block* input,
-    const AES_DecryptionRoundKeys* params,
-    AES_Block* output,
+static AES_StatusCode aes_expand_key_aes256_vperm(
+    const AES_Key* key,
+    AES_EncryptionRoundKeys* encryption_keys,
+    AES_DecryptionRoundKeys* decryption_keys,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_decrypt_params(input, params, output, err_details);
+    AES_StatusCode status = check_expand_key_params(key, encryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes192_decrypt_block(*input, &params->aes192_dec_keys);
+    aes256_expand_key_vperm(
+        key->aes256_key.lo,
+        key->aes256_key.hi,
+        &encryption_keys->aes256_enc_keys,
+        decryption_keys ? &decryption_keys->aes256_dec_keys : NULL
+    );
     return status;
 }
 
-static AES_StatusCode aes_encrypt_block_aes256(
+static AES_StatusCode check_encrypt_params(
     const AES_Block* input,
     const AES_EncryptionRoundKeys* params,
     AES_Block* output,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_encrypt_params(input, params, output, err_details);
-    if (aes_is_error(status))
-        return status;
-
-    *output = aes256_encrypt_block(*input, &params->aes256_enc_keys);
-    return status;
+    if (input == NULL)
+        return aes_error_null_argument(err_details, "input");
+    if (params == NULL)
+        return aes_error_null_argument(err_details, "params");
+    if (output == NULL)
+        return aes_error_null_argument(err_details, "output");
+    return AES_SUCCESS;
 }
 
-static AES_StatusCode aes_decrypt_block_aes256(
+static AES_StatusCode check_decrypt_params(
     const AES_Block* input,
     const AES_DecryptionRoundKeys* params,
     AES_Block* output,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = check_decrypt_params(input, params, output, err_details);
-    if (aes_is_error(status))
-        return status;
-
-    *output = aes256_decrypt_block(*input, &params->aes256_dec_keys);
-    return status;
+    if (input == NULL)
+        return aes_error_null_argument(err_details, "input");
+    if (params == NULL)
+        return aes_error_null_argument(err_details, "params");
+    if (output == NULL)
+        return aes_error_null_argument(err_details, "output");
+    return AES_SUCCESS;
 }
 
-static AES_Ops aes128_ops = {
-    &aes_parse_key_aes128,
-    &aes_format_key_aes128,
-    &aes_expand_key_aes128,
-    &aes_encrypt_block_aes128,
-    &aes_decrypt_block_aes128,
-};
+/* The chained modes only have unchecked functions, see AES_EncryptChainUnchecked. */
+#define AES_DEFINE_CHAIN_FUNCTION(alg, impl, mode)                                            \
+    static void aes_encrypt_##mode##_##alg##impl##_unchecked(                                 \
+        const AES_Block* input,                                                               \
+        size_t numof_blocks,                                                                  \
+        AES_Block* iv,                                                                        \
+        const AES_EncryptionRoundKeys* params,                                                \
+        AES_Block* output                                                                     \
+    ) {                                                                                       \
+        alg##_encrypt_##mode##impl(input, output, numof_blocks, iv, &params->alg##_enc_keys); \
+    }
 
-static AES_Ops aes192_ops = {
-    &aes_parse_key_aes192,
-    &aes_format_key_aes192,
-    &aes_expand_key_aes192,
-    &aes_encrypt_block_aes192,
-    &aes_decrypt_block_aes192,
-};
+/* The functions below come in pairs: the unchecked one calls the
+ * implementation's function, and the checked one checks the arguments & then
+ * calls the unchecked one.
+ * impl is the suffix of the implementation's functions (empty for AES-NI,
+ * _portable, _vperm, etc.). */
+#define AES_DEFINE_BLOCK_FUNCTIONS(alg, impl)                                             \
+    static AES_Block aes_encrypt_block_##alg##impl##_unchecked(                           \
+        AES_Block input,                                                                  \
+        const AES_EncryptionRoundKeys* params                                             \
+    ) {                                                                                   \
+        return alg##_encrypt_block##impl(input, &params->alg##_enc_keys);                 \
+    }                                                                                     \
+                                                                                          \
+    static AES_StatusCode aes_encrypt_block_##alg##impl(                                  \
+        const AES_Block* input,                                                           \
+        const AES_EncryptionRoundKeys* params,                                            \
+        AES_Block* output,                                                                \
+        AES_ErrorDetails* err_details                                                     \
+    ) {                                                                                   \
+        AES_StatusCode status = check_encrypt_params(input, params, output, err_details); \
+        if (aes_is_error(status))                                                         \
+            return status;                                                                \
+                                                                                          \
+        *output = aes_encrypt_block_##alg##impl##_unchecked(*input, params);              \
+        return status;                                                                    \
+    }                                                                                     \
+                                                                                          \
+    static AES_Block aes_decrypt_block_##alg##impl##_unchecked(                           \
+        AES_Block input,                                                                  \
+        const AES_DecryptionRoundKeys* params                                             \
+    ) {                                                                                   \
+        return alg##_decrypt_block##impl(input, &params->alg##_dec_keys);                 \
+    }                                                                                     \
+                                                                                          \
+    static AES_StatusCode aes_decrypt_block_##alg##impl(                                  \
+        const AES_Block* input,                                                           \
+        const AES_DecryptionRoundKeys* params,                                            \
+        AES_Block* output,                                                                \
+        AES_ErrorDetails* err_details                                                     \
+    ) {                                                                                   \
+        AES_StatusCode status = check_decrypt_params(input, params, output, err_details); \
+        if (aes_is_error(status))                                                         \
+            return status;                                                                \
+                                                                                          \
+        *output = aes_decrypt_block_##alg##impl##_unchecked(*input, params);              \
+        return status;                                                                    \
+    }                                                                                     \
+                                                                                          \
+    static void aes_encrypt_pair_##alg##impl##_unchecked(                                 \
+        const AES_Block* input,                                                           \
+        const AES_EncryptionRoundKeys* params,                                            \
+        AES_Block* output                                                                 \
+    ) {                                                                                   \
+        alg##_encrypt_pair##impl(input, output, &params->alg##_enc_keys);                 \
+    }                                                                                     \
+                                                                                          \
+    AES_DEFINE_CHAIN_FUNCTION(alg, impl, cbc)                                             \
+    AES_DEFINE_CHAIN_FUNCTION(alg, impl, cfb)                                             \
+    AES_DEFINE_CHAIN_FUNCTION(alg, impl, ofb)
+
+AES_DEFINE_BLOCK_FUNCTIONS(aes128, )
+AES_DEFINE_BLOCK_FUNCTIONS(aes192, )
+AES_DEFINE_BLOCK_FUNCTIONS(aes256, )
+AES_DEFINE_BLOCK_FUNCTIONS(aes128, _portable)
+AES_DEFINE_BLOCK_FUNCTIONS(aes192, _portable)
+AES_DEFINE_BLOCK_FUNCTIONS(aes256, _portable)
+AES_DEFINE_BLOCK_FUNCTIONS(aes128, _vperm)
+AES_DEFINE_BLOCK_FUNCTIONS(aes192, _vperm)
+AES_DEFINE_BLOCK_FUNCTIONS(aes256, _vperm)
+
+static AES_StatusCode check_encrypt_blocks_params(
+    const AES_Block* input,
+    size_t numof_blocks,
+    const AES_EncryptionRoundKeys* params,
+    AES_Block* output,
+    AES_ErrorDetails* err_details
+) {
+    if (input == NULL && numof_blocks != 0)
+        return aes_error_null_argument(err_details, "input");
+    if (params == NULL)
+        return aes_error_null_argument(err_details, "params");
+    if (output == NULL && numof_blocks != 0)
+        return aes_error_null_argument(err_details, "output");
+    return AES_SUCCESS;
+}
 
-static AES_Ops aes256_ops = {
-    &aes_parse_key_aes256,
-    &aes_format_key_aes256,
-    &aes_expand_key_aes256,
-    &aes_encrypt_block_aes256,
-    &aes_decrypt_block_aes256,
-};
+static AES_StatusCode check_decrypt_blocks_params(
+    const AES_Block* input,
+    size_t numof_blocks,
+    const AES_DecryptionRoundKeys* params,
+    AES_Block* output,
+    AES_ErrorDetails* err_details
+) {
+    if (input == NULL && numof_blocks != 0)
+        return aes_error_null_argument(err_details, "input");
+    if (params == NULL)
+        return aes_error_null_argument(err_details, "params");
+    if (output == NULL && numof_blocks != 0)
+        return aes_error_null_argument(err_details, "output");
+    return AES_SUCCESS;
+}
 
-static const AES_Ops* aes_ops_list[] = {
-    &aes128_ops,
-    &aes192_ops,
-    &aes256_ops,
+/* Defines the multi-block functions & the ops of an implementation.
+ * The VAES implementations only have multi-block functions, and use the
+ * AES-NI key schedule & single-block functions, hence block_impl. */
+#define AES_DEFINE_OPS(alg, impl, block_impl)                                              \
+    static void aes_encrypt_blocks_##alg##impl##_unchecked(                                \
+        const AES_Block* input,                                                            \
+        size_t numof_blocks,                                                               \
+        const AES_EncryptionRoundKeys* params,                                             \
+        AES_Block* output                                                                  \
+    ) {                                                                                    \
+        alg##_encrypt_blocks##impl(input, output, numof_blocks, &params->alg##_enc_keys);  \
+    }                                                                                      \
+                                                                                           \
+    static AES_StatusCode aes_encrypt_blocks_##alg##impl(                                  \
+        const AES_Block* input,                                                            \
+        size_t numof_blocks,                                                               \
+        const AES_EncryptionRoundKeys* params,                                             \
+        AES_Block* output,                                                                 \
+        AES_ErrorDetails* err_details                                                      \
+    ) {                                                                                    \
+        AES_StatusCode status =                                                            \
+            check_encrypt_blocks_params(input, numof_blocks, params, output, err_details); \
+        if (aes_is_error(status))                                                          \
+            return status;                                                                 \
+                                                                                           \
+        aes_encrypt_blocks_##alg##impl##_unchecked(input, numof_blocks, params, output);   \
+        return status;                                                                     \
+    }                                                                                      \
+                                                                                           \
+    static void aes_decrypt_blocks_##alg##impl##_unchecked(                                \
+        const AES_Block* input,                                                            \
+        size_t numof_blocks,                                                               \
+        const AES_DecryptionRoundKeys* params,                                             \
+        AES_Block* output                                                                  \
+    ) {                                                                                    \
+        alg##_decrypt_blocks##impl(input, output, numof_blocks, &params->alg##_dec_keys);  \
+    }                                                                                      \
+                                                                                           \
+    static AES_StatusCode aes_decrypt_blocks_##alg##impl(                                  \
+        const AES_Block* input,                                                            \
+        size_t numof_blocks,                                                               \
+        const AES_DecryptionRoundKeys* params,                                             \
+        AES_Block* output,                                                                 \
+        AES_ErrorDetails* err_details                                                      \
+    ) {                                                                                    \
+        AES_StatusCode status =                                                            \
+            check_decrypt_blocks_params(input, numof_blocks, params, output, err_details); \
+        if (aes_is_error(status))                                                          \
+            return status;                                                                 \
+                                                                                           \
+        aes_decrypt_blocks_##alg##impl##_unchecked(input, numof_blocks, params, output);   \
+        return status;                                                                     \
+    }                                                                                      \
+                                                                                           \
+    static AES_UncheckedOps alg##impl##_unchecked_ops = {                                  \
+        &aes_encrypt_block_##alg##block_impl##_unchecked,                                  \
+        &aes_decrypt_block_##alg##block_impl##_unchecked,                                  \
+        &aes_encrypt_blocks_##alg##impl##_unchecked,                                       \
+        &aes_decrypt_blocks_##alg##impl##_unchecked,                                       \
+        &aes_encrypt_pair_##alg##block_impl##_unchecked,                                   \
+        &aes_encrypt_cbc_##alg##block_impl##_unchecked,                                    \
+        &aes_encrypt_cfb_##alg##block_impl##_unchecked,                                    \
+        &aes_encrypt_ofb_##alg##block_impl##_unchecked,                                    \
+    };                                                                                     \
+                                                                                           \
+    static AES_Ops alg##impl##_ops = {                                                     \
+        &aes_parse_key_##alg,                                                              \
+        &aes_format_key_##alg,                                                             \
+        &aes_expand_key_##alg##block_impl,                                                 \
+        &aes_encrypt_block_##alg##block_impl,                                              \
+        &aes_decrypt_block_##alg##block_impl,                                              \
+        &aes_encrypt_blocks_##alg##impl,                                                   \
+        &aes_decrypt_blocks_##alg##impl,                                                   \
+        &alg##impl##_unchecked_ops,                                                        \
+    };
+
+AES_DEFINE_OPS(aes128, , )
+AES_DEFINE_OPS(aes192, , )
+AES_DEFINE_OPS(aes256, , )
+AES_DEFINE_OPS(aes128, _portable, _portable)
+AES_DEFINE_OPS(aes192, _portable, _portable)
+AES_DEFINE_OPS(aes256, _portable, _portable)
+AES_DEFINE_OPS(aes128, _vperm, _vperm)
+AES_DEFINE_OPS(aes192, _vperm, _vperm)
+AES_DEFINE_OPS(aes256, _vperm, _vperm)
+AES_DEFINE_OPS(aes128, _vaes, )
+AES_DEFINE_OPS(aes192, _vaes, )
+AES_DEFINE_OPS(aes256, _vaes, )
+AES_DEFINE_OPS(aes128, _vaes512, )
+AES_DEFINE_OPS(aes192, _vaes512, )
+AES_DEFINE_OPS(aes256, _vaes512, )
+
+static const AES_Ops* aes_ops_list[][3] = {
+    {
+        &aes128_portable_ops,
+        &aes192_portable_ops,
+        &aes256_portable_ops,
+    },
+    {
+        &aes128_ops,
+        &aes192_ops,
+        &aes256_ops,
+    },
+    {
+        &aes128_vperm_ops,
+        &aes192_vperm_ops,
+        &aes256_vperm_ops,
+    },
+    {
+        &aes128_vaes_ops,
+        &aes192_vaes_ops,
+        &aes256_vaes_ops,
+    },
+    {
+        &aes128_vaes512_ops,
+        &aes192_vaes512_ops,
+        &aes256_vaes512_ops,
+    },
 };
 
-const AES_Ops* aes_get_ops(AES_Algorithm algorithm) {
+_Static_assert(
+    sizeof(aes_ops_list) / sizeof(aes_ops_list[0]) == AesImplCount,
+    "Missing implementation ops"
+);
+
+const AES_Ops* aes_get_impl_ops(AES_Implementation impl, AES_Algorithm algorithm) {
     int l = 0;
-    size_t r = sizeof(aes_ops_list) / sizeof(aes_ops_list[0]) - 1;
+    size_t r = sizeof(aes_ops_list[0]) / sizeof(aes_ops_list[0][0]) - 1;
 
+    if ((int)impl < l || impl >= AesImplCount) {
+        assert(0);
+        return NULL;
+    }
     if ((int)algorithm < l || (size_t)algorithm > r) {
         assert(0);
         return NULL;
     }
 
-    return aes_ops_list[algorithm];
+    return aes_ops_list[impl][algorithm];
+}
+
+const AES_Ops* aes_get_ops(AES_Algorithm algorithm) {
+    return aes_get_impl_ops(aes_get_impl(), algorithm);
 }
 
 AES_StatusCode aes_parse_key(
@@ -13,17 +13,25 @@
 #include <string.h>
 #include <tmmintrin.h>
 
-static AES_Block reverse_byte_order(AES_Block block) {
-    return _mm_shuffle_epi8(block, aes_make_block(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f));
-}
-
 AES_Block aes_inc_block(AES_Block x) {
-    x = reverse_byte_order(x);
+    x = aes_reverse_byte_order(x);
     x = _mm_add_epi32(x, aes_make_block(0, 0, 0, 1));
-    x = reverse_byte_order(x);
+    x = aes_reverse_byte_order(x);
     return x;
 }
 
+AES_Block aes_double_block(AES_Block x) {
+    AES_ALIGN(unsigned char, 16) bytes[16];
+    aes_store_block_aligned(bytes, x);
+
+    const unsigned char carry = bytes[0] >> 7;
+    for (int i = 0; i < 15; ++i)
+        bytes[i] = (unsigned char)(bytes[i] << 1 | bytes[i + 1] >> 7);
+    bytes[15] = (unsigned char)(bytes[15] << 1 ^ carry * 0x87);
+
+    return aes_load_block_aligned(bytes);
+}
+
 AES_StatusCode aes_format_block(
     AES_BlockString* str,
     const AES_Block* block,
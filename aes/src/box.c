@@ -10,6 +10,101 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* A0 = flags || nonce || 0, the flags being q - 1, where q = 15 - nonce_size
+ * is the size of the counter. */
+static void aes_box_init_ccm_state(AES_Box* box, size_t nonce_size, size_t tag_size) {
+    AES_ALIGN(unsigned char, 16) iv[16];
+    AES_ALIGN(unsigned char, 16) a0[16];
+
+    aes_store_block_aligned(iv, box->iv);
+    memset(a0, 0x00, sizeof(a0));
+    a0[0] = (unsigned char)(15 - nonce_size - 1);
+    memcpy(a0 + 1, iv, nonce_size);
+
+    box->ccm.nonce_size = nonce_size;
+    box->ccm.tag_size = tag_size;
+    box->ccm.a0 = aes_load_block_aligned(a0);
+    box->ccm.aad = NULL;
+    box->ccm.aad_size = 0;
+    box->ccm.mac = _mm_setzero_si128();
+}
+
+/* Offset_0 = Stretch[1 + bottom..128 + bottom], where Nonce = 0^31 || 1 || N
+ * (for 128-bit tags), bottom is its last 6 bits,
+ * Ktop = E(Nonce with the last 6 bits zeroed) and
+ * Stretch = Ktop || (Ktop[1..64] ^ Ktop[9..72]). */
+static AES_StatusCode aes_box_init_ocb_nonce(AES_Box* box, AES_ErrorDetails* err_details) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block block;
+
+    AES_ALIGN(unsigned char, 16) nonce[16];
+    unsigned char stretch[24];
+
+    aes_store_block_aligned(nonce, box->iv);
+    memmove(nonce + 4, nonce, 12);
+    memset(nonce, 0x00, 4);
+    nonce[3] = 0x01;
+
+    const size_t bottom = nonce[15] & 0x3f;
+    nonce[15] &= 0xc0;
+
+    block = aes_load_block_aligned(nonce);
+    status = box->ops->encrypt_block(&block, &box->encryption_keys, &block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block(stretch, block);
+    for (int i = 0; i < 8; ++i)
+        stretch[16 + i] = stretch[i] ^ stretch[i + 1];
+
+    const size_t shift = bottom / 8, bits = bottom % 8;
+    for (size_t i = 0; i < 16; ++i)
+        nonce[i] =
+            (unsigned char)(stretch[i + shift] << bits | stretch[i + shift + 1] >> (8 - bits));
+
+    box->ocb.offset0 = aes_load_block_aligned(nonce);
+    return status;
+}
+
+/* Computes the L values & Offset_0. */
+static AES_StatusCode aes_box_init_ocb_state(AES_Box* box, AES_ErrorDetails* err_details) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block block = _mm_setzero_si128();
+
+    status = box->ops->encrypt_block(&block, &box->encryption_keys, &box->ocb.l_star, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    box->ocb.l_dollar = aes_double_block(box->ocb.l_star);
+    box->ocb.l[0] = aes_double_block(box->ocb.l_dollar);
+    for (int i = 1; i < AES_BOX_OCB_NUMOF_L; ++i)
+        box->ocb.l[i] = aes_double_block(box->ocb.l[i - 1]);
+
+    /* ntz(1), ..., ntz(7) */
+    static const int ntz[7] = {0, 1, 0, 2, 0, 1, 0};
+    AES_Block sum = _mm_setzero_si128();
+    for (int i = 0; i < 7; ++i) {
+        sum = aes_xor_blocks(sum, box->ocb.l[ntz[i]]);
+        box->ocb.l_sums[i] = sum;
+    }
+
+    box->ocb.hash = _mm_setzero_si128();
+    return aes_box_init_ocb_nonce(box, err_details);
+}
+
+/* J0 = IV || 0^31 || 1 for 96-bit IVs. */
+static AES_Block aes_box_get_j0_gcm(AES_Block iv) {
+    return _mm_or_si128(
+        _mm_and_si128(iv, aes_make_block(0, -1, -1, -1)), aes_make_block(0x01000000, 0, 0, 0)
+    );
+}
+
+static void aes_box_reset_stream(AES_Box* box) {
+    box->stream.buffer_size = 0;
+    box->stream.message_size = 0;
+    box->stream.started = 0;
+}
+
 AES_StatusCode aes_box_init(
     AES_Box* box,
     AES_Algorithm algorithm,
@@ -22,121 +117,163 @@ AES_StatusCode aes_box_init(
 
     box->algorithm = algorithm;
     box->mode = mode;
+    aes_box_reset_stream(box);
 
+    if (mode == AES_XTS)
+        return aes_error_not_implemented(
+            err_details, "XTS requires two keys, see aes_box_init_xts"
+        );
     if (!iv && aes_mode_requires_init_vector(mode))
         return aes_error_mode_requires_init_vector(err_details);
     if (iv)
         box->iv = *iv;
 
-    box->ops = aes_get_ops(algorithm);
+    if (mode == AES_GCM_SIV && algorithm == AES_AES192)
+        return aes_error_not_implemented(
+            err_details, "GCM-SIV is only defined for AES-128 and AES-256"
+        );
+
+    const AES_Implementation impl = aes_get_impl();
+    box->ops = aes_get_impl_ops(impl, algorithm);
 
     status =
         box->ops->expand_key(box_key, &box->encryption_keys, &box->decryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    return status;
-}
+    if (mode == AES_GCM) {
+        const AES_Block zero = _mm_setzero_si128();
+        AES_Block h;
 
-static AES_StatusCode aes_box_encrypt_block_ecb(
-    AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
-    AES_ErrorDetails* err_details
-) {
-    return box->ops->encrypt_block(input, &box->encryption_keys, output, err_details);
-}
+        status = box->ops->encrypt_block(&zero, &box->encryption_keys, &h, err_details);
+        if (aes_is_error(status))
+            return status;
 
-static AES_StatusCode aes_box_encrypt_block_cbc(
-    AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
-    AES_ErrorDetails* err_details
-) {
-    AES_StatusCode status = AES_SUCCESS;
-    AES_Block xored_input = aes_xor_blocks(*input, box->iv);
+        box->gcm.ops = aes_get_impl_ghash_ops(impl);
+        box->gcm.ops->init_key(&box->gcm.key, h);
 
-    status = box->ops->encrypt_block(&xored_input, &box->encryption_keys, output, err_details);
-    if (aes_is_error(status))
-        return status;
+        box->gcm.j0 = aes_box_get_j0_gcm(box->iv);
+        box->gcm.hash = zero;
+        box->gcm.aad_size = 0;
+    }
+
+    if (mode == AES_CCM)
+        aes_box_init_ccm_state(box, AES_BOX_CCM_NONCE_SIZE, AES_BOX_TAG_SIZE);
+
+    if (mode == AES_OCB) {
+        status = aes_box_init_ocb_state(box, err_details);
+        if (aes_is_error(status))
+            return status;
+    }
 
-    box->iv = *output;
+    if (mode == AES_GCM_SIV) {
+        box->gcm_siv.ops = aes_get_impl_ghash_ops(impl);
+        box->gcm_siv.aad = NULL;
+        box->gcm_siv.aad_size = 0;
+    }
+
+    box->tag = _mm_setzero_si128();
     return status;
 }
 
-static AES_StatusCode aes_box_encrypt_block_cfb(
+AES_StatusCode aes_box_init_ccm(
     AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
+    AES_Algorithm algorithm,
+    const AES_Key* box_key,
+    const AES_Block* iv,
+    size_t nonce_size,
+    size_t tag_size,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
 
-    status = box->ops->encrypt_block(&box->iv, &box->encryption_keys, output, err_details);
+    if (nonce_size < 7 || nonce_size > 13)
+        return aes_error_not_implemented(err_details, "CCM nonces must be 7 to 13 bytes long");
+    if (tag_size < 4 || tag_size > 16 || tag_size % 2 != 0)
+        return aes_error_not_implemented(
+            err_details, "CCM tags must be 4, 6, 8, 10, 12, 14 or 16 bytes long"
+        );
+
+    status = aes_box_init(box, algorithm, box_key, AES_CCM, iv, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes_xor_blocks(*output, *input);
-    box->iv = *output;
-
+    aes_box_init_ccm_state(box, nonce_size, tag_size);
     return status;
 }
 
-static AES_StatusCode aes_box_encrypt_block_ofb(
+AES_StatusCode aes_box_init_xts(
     AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
+    AES_Algorithm algorithm,
+    const AES_Key* box_key,
+    const AES_Key* tweak_key,
+    const AES_Block* iv,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
 
-    status = box->ops->encrypt_block(&box->iv, &box->encryption_keys, &box->iv, err_details);
+    if (algorithm == AES_AES192)
+        return aes_error_not_implemented(
+            err_details, "XTS is only defined for AES-128 and AES-256"
+        );
+
+    box->algorithm = algorithm;
+    box->mode = AES_XTS;
+    box->iv = iv ? *iv : _mm_setzero_si128();
+    aes_box_reset_stream(box);
+
+    const AES_Implementation impl = aes_get_impl();
+    box->ops = aes_get_impl_ops(impl, algorithm);
+
+    status =
+        box->ops->expand_key(box_key, &box->encryption_keys, &box->decryption_keys, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = box->iv;
-    *output = aes_xor_blocks(*output, *input);
-
-    return status;
+    /* The tweaks are only ever encrypted. */
+    return box->ops->expand_key(tweak_key, &box->xts.tweak_keys, NULL, err_details);
 }
 
-static AES_StatusCode aes_box_encrypt_block_ctr(
-    AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
-    AES_ErrorDetails* err_details
-) {
-    AES_StatusCode status = AES_SUCCESS;
+AES_StatusCode aes_box_set_iv(AES_Box* box, const AES_Block* iv, AES_ErrorDetails* err_details) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (iv == NULL)
+        return aes_error_null_argument(err_details, "iv");
 
-    status = box->ops->encrypt_block(&box->iv, &box->encryption_keys, output, err_details);
-    if (aes_is_error(status))
-        return status;
+    box->iv = *iv;
 
-    *output = aes_xor_blocks(*output, *input);
-    box->iv = aes_inc_block(box->iv);
+    /* The hash of an abandoned message (and its AAD) is thrown away. */
+    if (box->stream.started) {
+        if (box->mode == AES_GCM) {
+            box->gcm.hash = _mm_setzero_si128();
+            box->gcm.aad_size = 0;
+        }
+        if (box->mode == AES_OCB)
+            box->ocb.hash = _mm_setzero_si128();
+        aes_box_reset_stream(box);
+    }
 
-    return status;
-}
+    switch (box->mode) {
+        case AES_GCM:
+            box->gcm.j0 = aes_box_get_j0_gcm(box->iv);
+            return AES_SUCCESS;
 
-typedef AES_StatusCode (*AES_BoxEncryptBlockInMode)(
-    AES_Box*,
-    const AES_Block*,
-    AES_Block*,
-    AES_ErrorDetails*
-);
+        case AES_CCM:
+            aes_box_init_ccm_state(box, box->ccm.nonce_size, box->ccm.tag_size);
+            return AES_SUCCESS;
 
-static AES_BoxEncryptBlockInMode aes_box_encrypt_block_in_mode[] = {
-    &aes_box_encrypt_block_ecb,
-    &aes_box_encrypt_block_cbc,
-    &aes_box_encrypt_block_cfb,
-    &aes_box_encrypt_block_ofb,
-    &aes_box_encrypt_block_ctr,
-};
+        case AES_OCB:
+            return aes_box_init_ocb_nonce(box, err_details);
 
-AES_StatusCode aes_box_encrypt_block(
-    AES_Box* box,
+        default:
+            return AES_SUCCESS;
+    }
+}
+
+static AES_StatusCode aes_box_check_block_params(
+    const AES_Box* box,
     const AES_Block* input,
-    AES_Block* output,
+    const AES_Block* output,
     AES_ErrorDetails* err_details
 ) {
     if (box == NULL)
@@ -145,395 +282,3736 @@ AES_StatusCode aes_box_encrypt_block(
         return aes_error_null_argument(err_details, "input");
     if (output == NULL)
         return aes_error_null_argument(err_details, "output");
-
-    return aes_box_encrypt_block_in_mode[box->mode](box, input, output, err_details);
+    if (aes_mode_is_authenticated(box->mode))
+        return aes_error_not_implemented(
+            err_details, "authenticated modes only support whole buffers"
+        );
+    return AES_SUCCESS;
 }
 
-static AES_StatusCode aes_box_decrypt_block_ecb(
+AES_StatusCode aes_box_encrypt_block(
     AES_Box* box,
     const AES_Block* input,
     AES_Block* output,
     AES_ErrorDetails* err_details
 ) {
-    return box->ops->decrypt_block(input, &box->decryption_keys, output, err_details);
+    AES_StatusCode status = aes_box_check_block_params(box, input, output, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_box_encrypt_block_unchecked(box, input, output);
+    return status;
 }
 
-static AES_StatusCode aes_box_decrypt_block_cbc(
+AES_StatusCode aes_box_decrypt_block(
     AES_Box* box,
     const AES_Block* input,
     AES_Block* output,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = AES_SUCCESS;
-
-    status = box->ops->decrypt_block(input, &box->decryption_keys, output, err_details);
+    AES_StatusCode status = aes_box_check_block_params(box, input, output, err_details);
     if (aes_is_error(status))
         return status;
 
-    *output = aes_xor_blocks(*output, box->iv);
-    box->iv = *input;
-
+    aes_box_decrypt_block_unchecked(box, input, output);
     return status;
 }
 
-static AES_StatusCode aes_box_decrypt_block_cfb(
+/* Number of blocks passed to the multi-block functions at a time.
+ * The VAES implementations need this many to keep all of their registers
+ * busy. */
+#define AES_BOX_BATCH_LEN 32
+
+/* The buffer functions below process a number of complete blocks at once.
+ * The arguments are expected to have already been checked by the caller. */
+
+static AES_StatusCode aes_box_encrypt_blocks_ecb(
     AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
     AES_ErrorDetails* err_details
 ) {
-    AES_StatusCode status = AES_SUCCESS;
-
-    status = box->ops->encrypt_block(&box->iv, &box->encryption_keys, output, err_details);
-    if (aes_is_error(status))
-        return status;
+    return box->ops->encrypt_blocks(
+        (const AES_Block*)src, numof_blocks, &box->encryption_keys, (AES_Block*)dest, err_details
+    );
+}
 
-    *output = aes_xor_blocks(*output, *input);
-    box->iv = *input;
+static AES_StatusCode aes_box_encrypt_blocks_cbc(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_UNUSED_PARAMETER(err_details);
 
-    return status;
+    box->ops->unchecked->encrypt_cbc(
+        (const AES_Block*)src, numof_blocks, &box->iv, &box->encryption_keys, (AES_Block*)dest
+    );
+    return AES_SUCCESS;
 }
 
-typedef AES_BoxEncryptBlockInMode AES_BoxDecryptBlockInMode;
+static AES_StatusCode aes_box_encrypt_blocks_cfb(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_UNUSED_PARAMETER(err_details);
 
-static AES_BoxDecryptBlockInMode aes_box_decrypt_block_in_mode[] = {
-    &aes_box_decrypt_block_ecb,
-    &aes_box_decrypt_block_cbc,
-    &aes_box_decrypt_block_cfb,
-    &aes_box_encrypt_block_ofb,
-    &aes_box_encrypt_block_ctr,
-};
+    box->ops->unchecked->encrypt_cfb(
+        (const AES_Block*)src, numof_blocks, &box->iv, &box->encryption_keys, (AES_Block*)dest
+    );
+    return AES_SUCCESS;
+}
 
-AES_StatusCode aes_box_decrypt_block(
+static AES_StatusCode aes_box_encrypt_blocks_ofb(
     AES_Box* box,
-    const AES_Block* input,
-    AES_Block* output,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
     AES_ErrorDetails* err_details
 ) {
-    return aes_box_decrypt_block_in_mode[box->mode](box, input, output, err_details);
+    AES_UNUSED_PARAMETER(err_details);
+
+    box->ops->unchecked->encrypt_ofb(
+        (const AES_Block*)src, numof_blocks, &box->iv, &box->encryption_keys, (AES_Block*)dest
+    );
+    return AES_SUCCESS;
 }
 
-static AES_StatusCode aes_box_get_encrypted_buffer_size(
+static AES_StatusCode aes_box_encrypt_blocks_ctr(
     AES_Box* box,
-    size_t src_size,
-    size_t* dest_size,
-    size_t* padding_size,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
+    AES_Block keystream[AES_BOX_BATCH_LEN];
 
-    switch (box->mode) {
-        case AES_ECB:
-        case AES_CBC: {
-            size_t block_size = sizeof(AES_Block);
-            *padding_size = block_size - src_size % block_size;
-            *dest_size = src_size + *padding_size;
-            return status;
+    /* Keep the counter with its bytes reversed, so that it can be incremented
+     * with a single instruction (see aes_inc_block). */
+    const AES_Block one = aes_make_block(0, 0, 0, 1);
+    AES_Block counter = aes_reverse_byte_order(box->iv);
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        for (size_t i = 0; i < batch_len; ++i) {
+            keystream[i] = aes_reverse_byte_order(counter);
+            counter = _mm_add_epi32(counter, one);
         }
 
-        case AES_CFB:
-        case AES_OFB:
-        case AES_CTR:
-            *dest_size = src_size;
-            *padding_size = 0;
+        status = box->ops->encrypt_blocks(
+            keystream, batch_len, &box->encryption_keys, keystream, err_details
+        );
+        if (aes_is_error(status))
             return status;
 
-        default:
-            return aes_error_not_implemented(err_details, "unsupported mode of operation");
+        for (size_t i = 0; i < batch_len; ++i) {
+            aes_store_block(dest, aes_xor_blocks(keystream[i], aes_load_block(src)));
+            src = (const char*)src + sizeof(AES_Block);
+            dest = (char*)dest + sizeof(AES_Block);
+        }
+
+        numof_blocks -= batch_len;
     }
+
+    box->iv = aes_reverse_byte_order(counter);
+    return status;
 }
 
-static AES_StatusCode aes_box_encrypt_buffer_block(
+/* GCM is CTR, except the ciphertext is also hashed.
+ * It's hashed one batch at a time, while the batch is still in the cache. */
+static AES_StatusCode aes_box_encrypt_blocks_gcm(
     AES_Box* box,
     const void* src,
+    size_t numof_blocks,
     void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
-    AES_Block plaintext = aes_load_block(src);
-    AES_Block ciphertext;
 
-    status = aes_box_encrypt_block(box, &plaintext, &ciphertext, err_details);
-    if (aes_is_error(status))
-        return status;
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        status = aes_box_encrypt_blocks_ctr(box, src, batch_len, dest, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        box->gcm.hash = box->gcm.ops->ghash(box->gcm.hash, dest, batch_len, &box->gcm.key);
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
 
-    aes_store_block(dest, ciphertext);
     return status;
 }
 
-static AES_StatusCode aes_box_encrypt_buffer_partial_block_with_padding(
+/* Multiplies the tweak by alpha (x) in GF(2^128), the tweak being a 128-bit
+ * little-endian number. */
+static AES_Block aes_box_mul_alpha_xts(AES_Block tweak) {
+    /* The top bit of the low half moves to the high half, the top bit of the
+     * high half is reduced into the low half. */
+    AES_Block carry = _mm_shuffle_epi32(_mm_srli_epi64(tweak, 63), 0x4e);
+    carry = _mm_mul_epu32(carry, aes_make_block(0, 1, 0, 0x87));
+    return _mm_xor_si128(_mm_slli_epi64(tweak, 1), carry);
+}
+
+/* Multiplies the tweak by alpha^8: shifts it by a byte & reduces the top byte b
+ * (b * x^128 = b * (x^7 + x^2 + x + 1)). */
+static AES_Block aes_box_mul_alpha8_xts(AES_Block tweak) {
+    const AES_Block b = _mm_srli_si128(tweak, 15);
+    AES_Block carry = _mm_xor_si128(b, _mm_slli_epi16(b, 1));
+    carry = _mm_xor_si128(carry, _mm_slli_epi16(b, 2));
+    carry = _mm_xor_si128(carry, _mm_slli_epi16(b, 7));
+    return _mm_xor_si128(_mm_slli_si128(tweak, 1), carry);
+}
+
+/* Fills tweaks with T, T * alpha, T * alpha^2, ... and returns the tweak of the
+ * next block.
+ * After the first 8, every tweak only depends on the one 8 blocks before it, so
+ * that 8 of them are computed in parallel. */
+static AES_Block aes_box_fill_tweaks_xts(AES_Block* tweaks, size_t numof_blocks, AES_Block tweak) {
+    tweaks[0] = tweak;
+    for (size_t i = 1; i < numof_blocks && i < 8; ++i)
+        tweaks[i] = aes_box_mul_alpha_xts(tweaks[i - 1]);
+    for (size_t i = 8; i < numof_blocks; ++i)
+        tweaks[i] = aes_box_mul_alpha8_xts(tweaks[i - 8]);
+    return aes_box_mul_alpha_xts(tweaks[numof_blocks - 1]);
+}
+
+/* The tweak (already encrypted) is updated to the tweak of the next block. */
+static AES_StatusCode aes_box_encrypt_tweaked_blocks_xts(
     AES_Box* box,
     const void* src,
-    size_t src_size,
+    size_t numof_blocks,
     void* dest,
-    size_t padding_size,
+    AES_Block* tweak,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
 
-    size_t block_size = sizeof(AES_Block);
-    void* plaintext_buf = malloc(block_size);
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
 
-    if (plaintext_buf == NULL)
-        return status = aes_error_memory_allocation(err_details);
+        *tweak = aes_box_fill_tweaks_xts(tweaks, batch_len, *tweak);
 
-    memcpy(plaintext_buf, src, src_size);
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)src + i * sizeof(AES_Block)), tweaks[i]
+            );
 
-    status = aes_fill_with_padding(
-        AES_PADDING_PKCS7, (char*)plaintext_buf + src_size, padding_size, err_details
-    );
-    if (aes_is_error(status))
-        goto FREE_PLAINTEXT_BUF;
+        status = box->ops->encrypt_blocks(
+            blocks, batch_len, &box->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
 
-    status = aes_box_encrypt_buffer_block(box, plaintext_buf, dest, err_details);
-    if (aes_is_error(status))
-        goto FREE_PLAINTEXT_BUF;
+        for (size_t i = 0; i < batch_len; ++i)
+            aes_store_block(
+                (char*)dest + i * sizeof(AES_Block), aes_xor_blocks(blocks[i], tweaks[i])
+            );
 
-FREE_PLAINTEXT_BUF:
-    free(plaintext_buf);
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
 
     return status;
 }
 
-static AES_StatusCode aes_box_encrypt_buffer_partial_block(
+/* Encrypts a single data unit (a sector) of at least one block.
+ * The last partial block, if any, steals the end of the previous ciphertext
+ * block. */
+static AES_StatusCode aes_box_encrypt_data_unit_xts(
     AES_Box* box,
     const void* src,
     size_t src_size,
+    AES_Block tweak,
     void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
 
-    if (src_size == 0)
-        return status;
-
     size_t block_size = sizeof(AES_Block);
-    void* plaintext_buf = malloc(block_size);
+    const size_t partial_size = src_size % block_size;
+    const size_t src_len = src_size / block_size - (partial_size != 0);
 
-    if (plaintext_buf == NULL)
-        return status = aes_error_memory_allocation(err_details);
+    status = aes_box_encrypt_tweaked_blocks_xts(box, src, src_len, dest, &tweak, err_details);
+    if (aes_is_error(status))
+        return status;
 
-    memset(plaintext_buf, 0x00, block_size);
-    memcpy(plaintext_buf, src, src_size);
+    if (partial_size == 0)
+        return status;
 
-    void* ciphertext_buf = malloc(block_size);
+    src = (const char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
 
-    if (ciphertext_buf == NULL) {
-        status = aes_error_memory_allocation(err_details);
-        goto FREE_PLAINTEXT_BUF;
-    }
+    AES_ALIGN(unsigned char, 16) cc[16];
+    AES_ALIGN(unsigned char, 16) pp[16];
+    AES_Block block = aes_xor_blocks(aes_load_block(src), tweak);
 
-    status = aes_box_encrypt_buffer_block(box, plaintext_buf, ciphertext_buf, err_details);
+    status = box->ops->encrypt_block(&block, &box->encryption_keys, &block, err_details);
     if (aes_is_error(status))
-        goto FREE_CIPHERTEXT_BUF;
+        return status;
+    aes_store_block_aligned(cc, aes_xor_blocks(block, tweak));
 
-    memcpy(dest, ciphertext_buf, src_size);
+    memcpy(pp, (const char*)src + block_size, partial_size);
+    memcpy(pp + partial_size, cc + partial_size, block_size - partial_size);
+    memcpy((char*)dest + block_size, cc, partial_size);
 
-FREE_CIPHERTEXT_BUF:
-    free(ciphertext_buf);
+    tweak = aes_box_mul_alpha_xts(tweak);
+    block = aes_xor_blocks(aes_load_block_aligned(pp), tweak);
 
-FREE_PLAINTEXT_BUF:
-    free(plaintext_buf);
+    status = box->ops->encrypt_block(&block, &box->encryption_keys, &block, err_details);
+    if (aes_is_error(status))
+        return status;
 
+    aes_store_block(dest, aes_xor_blocks(block, tweak));
     return status;
 }
 
-AES_StatusCode aes_box_encrypt_buffer(
+static AES_StatusCode aes_box_encrypt_blocks_xts(
     AES_Box* box,
     const void* src,
-    size_t src_size,
+    size_t numof_blocks,
     void* dest,
-    size_t* dest_size,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweak;
 
-    if (box == NULL)
-        return aes_error_null_argument(err_details, "box");
-    if (dest_size == NULL)
-        return aes_error_null_argument(err_details, "dest_size");
-
-    size_t padding_size = 0;
-
-    status =
-        aes_box_get_encrypted_buffer_size(box, src_size, dest_size, &padding_size, err_details);
+    status = box->ops->encrypt_block(&box->iv, &box->xts.tweak_keys, &tweak, err_details);
     if (aes_is_error(status))
         return status;
 
-    if (dest == NULL)
-        return AES_SUCCESS;
-    if (src == NULL && src_size != 0)
-        return aes_error_null_argument(err_details, "src");
+    return aes_box_encrypt_tweaked_blocks_xts(box, src, numof_blocks, dest, &tweak, err_details);
+}
 
-    size_t block_size = sizeof(AES_Block);
-    const size_t src_len = src_size / block_size;
+/* CCM is CBC-MAC over the plaintext & CTR.
+ * The MAC is a chain of dependent encryptions, while the keystream blocks are
+ * independent, so every MAC block is encrypted together with a keystream block.
+ * This keeps the AES unit busy while the MAC is waiting for the previous
+ * block. */
+static AES_StatusCode aes_box_encrypt_blocks_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_Block blocks[2];
 
-    for (size_t i = 0; i < src_len; ++i) {
-        status = aes_box_encrypt_buffer_block(box, src, dest, err_details);
-        if (aes_is_error(status))
-            return status;
+    AES_UNUSED_PARAMETER(err_details);
+
+    const AES_UncheckedOps* ops = box->ops->unchecked;
+    const AES_Block one = aes_make_block(0, 0, 0, 1);
+    AES_Block counter = aes_reverse_byte_order(box->iv);
+    AES_Block mac = box->ccm.mac;
+
+    for (size_t i = 0; i < numof_blocks; ++i) {
+        const AES_Block input = aes_load_block(src);
+
+        blocks[0] = aes_xor_blocks(mac, input);
+        blocks[1] = aes_reverse_byte_order(counter);
+        counter = _mm_add_epi32(counter, one);
 
-        src = (char*)src + block_size;
-        dest = (char*)dest + block_size;
+        ops->encrypt_pair(blocks, &box->encryption_keys, blocks);
+
+        mac = blocks[0];
+        aes_store_block(dest, aes_xor_blocks(blocks[1], input));
+
+        src = (const char*)src + sizeof(AES_Block);
+        dest = (char*)dest + sizeof(AES_Block);
     }
 
-    if (padding_size == 0)
-        return aes_box_encrypt_buffer_partial_block(
-            box, src, src_size % block_size, dest, err_details
-        );
-    else
-        return aes_box_encrypt_buffer_partial_block_with_padding(
-            box, src, src_size % block_size, dest, padding_size, err_details
-        );
+    box->ccm.mac = mac;
+    box->iv = aes_reverse_byte_order(counter);
+    return AES_SUCCESS;
 }
 
-static AES_StatusCode aes_box_get_decrypted_buffer_size(
-    AES_Box* box,
-    size_t src_size,
-    size_t* dest_size,
-    size_t* max_padding_size,
+static unsigned aes_box_ntz_ocb(unsigned long long i) {
+    unsigned n = 0;
+    for (; (i & 1) == 0; i >>= 1)
+        ++n;
+    return n;
+}
+
+/* Fills offsets with the offsets of blocks index + 1, ..., index + numof_blocks
+ * & returns the last one.
+ * In every group of 8 blocks starting after a multiple of 8, the offsets only
+ * depend on the offset before the group, so that they're computed in
+ * parallel. */
+static AES_Block aes_box_fill_offsets_ocb(
+    const AES_BoxOcb* ocb,
+    AES_Block* offsets,
+    size_t numof_blocks,
+    unsigned long long index,
+    AES_Block offset
+) {
+    size_t i = 0;
+
+    while (i < numof_blocks) {
+        if ((index + i) % 8 == 0 && numof_blocks - i >= 8) {
+            for (size_t j = 0; j < 7; ++j)
+                offsets[i + j] = aes_xor_blocks(offset, ocb->l_sums[j]);
+            offset = aes_xor_blocks(offsets[i + 6], ocb->l[aes_box_ntz_ocb(index + i + 8)]);
+            offsets[i + 7] = offset;
+            i += 8;
+        } else {
+            offset = aes_xor_blocks(offset, ocb->l[aes_box_ntz_ocb(index + i + 1)]);
+            offsets[i++] = offset;
+        }
+    }
+
+    return offset;
+}
+
+/* Unlike GCM & CCM, OCB doesn't need a separate pass over the data: every block
+ * is encrypted independently, the checksum is just an XOR of the plaintext
+ * blocks. */
+static AES_StatusCode aes_box_encrypt_blocks_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
+    AES_Block offsets[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
 
-    switch (box->mode) {
-        case AES_ECB:
-        case AES_CBC: {
-            size_t block_size = sizeof(AES_Block);
+    AES_Block offset = box->ocb.offset;
+    AES_Block checksum = box->ocb.checksum;
 
-            if (src_size == 0 || src_size % block_size != 0)
-                return aes_error_missing_padding(err_details);
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
 
-            *dest_size = src_size;
-            *max_padding_size = block_size;
+        offset = aes_box_fill_offsets_ocb(&box->ocb, offsets, batch_len, box->ocb.index, offset);
+
+        for (size_t i = 0; i < batch_len; ++i) {
+            const AES_Block input = aes_load_block((const char*)src + i * sizeof(AES_Block));
+            checksum = aes_xor_blocks(checksum, input);
+            blocks[i] = aes_xor_blocks(input, offsets[i]);
+        }
+
+        status = box->ops->encrypt_blocks(
+            blocks, batch_len, &box->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
             return status;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            aes_store_block(
+                (char*)dest + i * sizeof(AES_Block), aes_xor_blocks(blocks[i], offsets[i])
+            );
+
+        box->ocb.index += batch_len;
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
+
+    box->ocb.offset = offset;
+    box->ocb.checksum = checksum;
+    return status;
+}
+
+/* GCM-SIV's counter is the first 32 bits of the block as a little-endian
+ * number, so unlike CTR, it can be incremented without reversing the bytes.
+ * Decryption is the same. */
+static AES_StatusCode aes_box_encrypt_blocks_gcm_siv(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block keystream[AES_BOX_BATCH_LEN];
+
+    const AES_Block one = aes_make_block(0, 0, 0, 1);
+    AES_Block counter = box->gcm_siv.counter;
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        for (size_t i = 0; i < batch_len; ++i) {
+            keystream[i] = counter;
+            counter = _mm_add_epi32(counter, one);
         }
 
-        case AES_CFB:
-        case AES_OFB:
-        case AES_CTR:
-            *dest_size = src_size;
-            *max_padding_size = 0;
+        status = box->ops->encrypt_blocks(
+            keystream, batch_len, &box->gcm_siv.encryption_keys, keystream, err_details
+        );
+        if (aes_is_error(status))
             return status;
 
-        default:
-            return aes_error_not_implemented(err_details, "unsupported mode of operation");
+        for (size_t i = 0; i < batch_len; ++i) {
+            aes_store_block(dest, aes_xor_blocks(keystream[i], aes_load_block(src)));
+            src = (const char*)src + sizeof(AES_Block);
+            dest = (char*)dest + sizeof(AES_Block);
+        }
+
+        numof_blocks -= batch_len;
     }
+
+    box->gcm_siv.counter = counter;
+    return status;
+}
+
+typedef AES_StatusCode (*AES_BoxEncryptBlocksInMode)(
+    AES_Box*,
+    const void*,
+    size_t,
+    void*,
+    AES_ErrorDetails*
+);
+
+static AES_BoxEncryptBlocksInMode aes_box_encrypt_blocks_in_mode[] = {
+    &aes_box_encrypt_blocks_ecb,
+    &aes_box_encrypt_blocks_cbc,
+    &aes_box_encrypt_blocks_cfb,
+    &aes_box_encrypt_blocks_ofb,
+    &aes_box_encrypt_blocks_ctr,
+    &aes_box_encrypt_blocks_gcm,
+    &aes_box_encrypt_blocks_xts,
+    &aes_box_encrypt_blocks_ccm,
+    &aes_box_encrypt_blocks_ocb,
+    &aes_box_encrypt_blocks_gcm_siv,
+};
+
+static AES_StatusCode aes_box_decrypt_blocks_ecb(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    return box->ops->decrypt_blocks(
+        (const AES_Block*)src, numof_blocks, &box->decryption_keys, (AES_Block*)dest, err_details
+    );
 }
 
-static AES_StatusCode aes_box_decrypt_buffer_block(
+static AES_StatusCode aes_box_decrypt_blocks_cbc(
     AES_Box* box,
     const void* src,
+    size_t numof_blocks,
     void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
-    AES_Block ciphertext = aes_load_block(src);
-    AES_Block plaintext;
+    AES_Block iv = box->iv;
+    AES_Block output[AES_BOX_BATCH_LEN];
 
-    status = aes_box_decrypt_block(box, &ciphertext, &plaintext, err_details);
-    if (aes_is_error(status))
-        return status;
+    /* Unlike encryption, every block can be decrypted independently, the
+     * previous ciphertext block is only required for the final XOR. */
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
 
-    aes_store_block(dest, plaintext);
+        status = box->ops->decrypt_blocks(
+            (const AES_Block*)src, batch_len, &box->decryption_keys, output, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        /* Load each ciphertext block before it's overwritten in case the
+         * buffer is decrypted in place. */
+        for (size_t i = 0; i < batch_len; ++i) {
+            const AES_Block input = aes_load_block((const char*)src + i * sizeof(AES_Block));
+            aes_store_block((char*)dest + i * sizeof(AES_Block), aes_xor_blocks(output[i], iv));
+            iv = input;
+        }
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
+
+    box->iv = iv;
     return status;
 }
 
-static AES_StatusCode aes_box_decrypt_buffer_partial_block(
+static AES_StatusCode aes_box_decrypt_blocks_cfb(
     AES_Box* box,
     const void* src,
-    size_t src_size,
+    size_t numof_blocks,
     void* dest,
     AES_ErrorDetails* err_details
 ) {
     AES_StatusCode status = AES_SUCCESS;
+    AES_Block keystream[AES_BOX_BATCH_LEN];
 
-    if (src_size == 0)
+    if (numof_blocks == 0)
         return status;
 
-    size_t block_size = sizeof(AES_Block);
-    void* ciphertext_buf = malloc(block_size);
+    /* The keystream is E(C[i-1]), and all of the ciphertext blocks are known
+     * in advance.
+     * Only the first block depends on the IV, the rest of the keystream can be
+     * computed directly from the source buffer.
+     * The last block of every batch is stored after the next batch has been
+     * computed in case the buffer is decrypted in place. */
+    status = box->ops->encrypt_blocks(&box->iv, 1, &box->encryption_keys, keystream, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    AES_Block pending = aes_xor_blocks(keystream[0], aes_load_block(src));
 
-    if (ciphertext_buf == NULL)
-        return status = aes_error_memory_allocation(err_details);
+    const char* input = (const char*)src + sizeof(AES_Block);
+    char* output = (char*)dest;
+    --numof_blocks;
 
-    memset(ciphertext_buf, 0x00, block_size);
-    memcpy(ciphertext_buf, src, src_size);
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
 
-    void* plaintext_buf = malloc(block_size);
+        status = box->ops->encrypt_blocks(
+            (const AES_Block*)(input - sizeof(AES_Block)),
+            batch_len,
+            &box->encryption_keys,
+            keystream,
+            err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        aes_store_block(output, pending);
+        output += sizeof(AES_Block);
 
-    if (plaintext_buf == NULL) {
-        status = aes_error_memory_allocation(err_details);
-        goto FREE_CIPHERTEXT_BUF;
+        for (size_t i = 0; i + 1 < batch_len; ++i) {
+            aes_store_block(output, aes_xor_blocks(keystream[i], aes_load_block(input)));
+            input += sizeof(AES_Block);
+            output += sizeof(AES_Block);
+        }
+
+        pending = aes_xor_blocks(keystream[batch_len - 1], aes_load_block(input));
+        input += sizeof(AES_Block);
+        numof_blocks -= batch_len;
     }
 
-    status = aes_box_decrypt_buffer_block(box, ciphertext_buf, plaintext_buf, err_details);
-    if (aes_is_error(status))
-        goto FREE_PLAINTEXT_BUF;
+    box->iv = aes_load_block(input - sizeof(AES_Block));
+    aes_store_block(output, pending);
+    return status;
+}
+
+/* The ciphertext is hashed before it's overwritten in case the buffer is
+ * decrypted in place. */
+static AES_StatusCode aes_box_decrypt_blocks_gcm(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
 
-    memcpy(dest, plaintext_buf, src_size);
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
 
-FREE_PLAINTEXT_BUF:
-    free(plaintext_buf);
+        box->gcm.hash = box->gcm.ops->ghash(box->gcm.hash, src, batch_len, &box->gcm.key);
 
-FREE_CIPHERTEXT_BUF:
-    free(ciphertext_buf);
+        status = aes_box_encrypt_blocks_ctr(box, src, batch_len, dest, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
 
     return status;
 }
 
-AES_StatusCode aes_box_decrypt_buffer(
+static AES_StatusCode aes_box_decrypt_tweaked_blocks_xts(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_Block* tweak,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        *tweak = aes_box_fill_tweaks_xts(tweaks, batch_len, *tweak);
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)src + i * sizeof(AES_Block)), tweaks[i]
+            );
+
+        status = box->ops->decrypt_blocks(
+            blocks, batch_len, &box->decryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            aes_store_block(
+                (char*)dest + i * sizeof(AES_Block), aes_xor_blocks(blocks[i], tweaks[i])
+            );
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
+    }
+
+    return status;
+}
+
+/* The last complete ciphertext block is decrypted using the tweak of the
+ * partial block that follows it. */
+static AES_StatusCode aes_box_decrypt_data_unit_xts(
     AES_Box* box,
     const void* src,
     size_t src_size,
+    AES_Block tweak,
     void* dest,
-    size_t* dest_size,
     AES_ErrorDetails* err_details
 ) {
-    if (box == NULL)
-        return aes_error_null_argument(err_details, "box");
-    if (dest_size == NULL)
-        return aes_error_null_argument(err_details, "dest_size");
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t partial_size = src_size % block_size;
+    const size_t src_len = src_size / block_size - (partial_size != 0);
+
+    status = aes_box_decrypt_tweaked_blocks_xts(box, src, src_len, dest, &tweak, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (partial_size == 0)
+        return status;
+
+    src = (const char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    AES_ALIGN(unsigned char, 16) cc[16];
+    AES_ALIGN(unsigned char, 16) pp[16];
+    const AES_Block next_tweak = aes_box_mul_alpha_xts(tweak);
+    AES_Block block = aes_xor_blocks(aes_load_block(src), next_tweak);
 
+    status = box->ops->decrypt_block(&block, &box->decryption_keys, &block, err_details);
+    if (aes_is_error(status))
+        return status;
+    aes_store_block_aligned(pp, aes_xor_blocks(block, next_tweak));
+
+    memcpy(cc, (const char*)src + block_size, partial_size);
+    memcpy(cc + partial_size, pp + partial_size, block_size - partial_size);
+    memcpy((char*)dest + block_size, pp, partial_size);
+
+    block = aes_xor_blocks(aes_load_block_aligned(cc), tweak);
+
+    status = box->ops->decrypt_block(&block, &box->decryption_keys, &block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block(dest, aes_xor_blocks(block, tweak));
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_blocks_xts(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
     AES_StatusCode status = AES_SUCCESS;
-    size_t max_padding_size = 0;
+    AES_Block tweak;
 
-    status =
-        aes_box_get_decrypted_buffer_size(box, src_size, dest_size, &max_padding_size, err_details);
+    status = box->ops->encrypt_block(&box->iv, &box->xts.tweak_keys, &tweak, err_details);
     if (aes_is_error(status))
         return status;
 
-    if (dest == NULL)
+    return aes_box_decrypt_tweaked_blocks_xts(box, src, numof_blocks, dest, &tweak, err_details);
+}
+
+/* On decryption, the plaintext block (which is what the MAC is computed over)
+ * is only known after its keystream block is, so every MAC block is encrypted
+ * together with the keystream block for the next plaintext block. */
+static AES_StatusCode aes_box_decrypt_blocks_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_Block blocks[2];
+
+    AES_UNUSED_PARAMETER(err_details);
+
+    if (numof_blocks == 0)
         return AES_SUCCESS;
-    if (src == NULL)
-        return aes_error_null_argument(err_details, "src");
 
-    size_t block_size = sizeof(AES_Block);
-    const size_t src_len = src_size / block_size;
+    const AES_UncheckedOps* ops = box->ops->unchecked;
+    const AES_Block one = aes_make_block(0, 0, 0, 1);
+    AES_Block counter = aes_reverse_byte_order(box->iv);
+    AES_Block mac = box->ccm.mac;
 
-    for (size_t i = 0; i < src_len; ++i) {
-        status = aes_box_decrypt_buffer_block(box, src, dest, err_details);
-        if (aes_is_error(status))
-            return status;
+    blocks[1] = ops->encrypt_block(aes_reverse_byte_order(counter), &box->encryption_keys);
+    counter = _mm_add_epi32(counter, one);
+
+    AES_Block plaintext = aes_xor_blocks(blocks[1], aes_load_block(src));
+    aes_store_block(dest, plaintext);
+
+    for (size_t i = 1; i < numof_blocks; ++i) {
+        src = (const char*)src + sizeof(AES_Block);
+        dest = (char*)dest + sizeof(AES_Block);
+
+        blocks[0] = aes_xor_blocks(mac, plaintext);
+        blocks[1] = aes_reverse_byte_order(counter);
+        counter = _mm_add_epi32(counter, one);
+
+        ops->encrypt_pair(blocks, &box->encryption_keys, blocks);
 
-        src = (char*)src + block_size;
-        dest = (char*)dest + block_size;
+        mac = blocks[0];
+        plaintext = aes_xor_blocks(blocks[1], aes_load_block(src));
+        aes_store_block(dest, plaintext);
     }
 
-    if (max_padding_size == 0) {
-        return aes_box_decrypt_buffer_partial_block(
-            box, src, src_size % block_size, dest, err_details
-        );
-    } else {
-        size_t padding_size;
+    mac = ops->encrypt_block(aes_xor_blocks(mac, plaintext), &box->encryption_keys);
 
-        status = aes_extract_padding_size(
-            AES_PADDING_PKCS7, (char*)dest - block_size, block_size, &padding_size, err_details
+    box->ccm.mac = mac;
+    box->iv = aes_reverse_byte_order(counter);
+    return AES_SUCCESS;
+}
+
+static AES_StatusCode aes_box_decrypt_blocks_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block offsets[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    AES_Block offset = box->ocb.offset;
+    AES_Block checksum = box->ocb.checksum;
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        offset = aes_box_fill_offsets_ocb(&box->ocb, offsets, batch_len, box->ocb.index, offset);
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)src + i * sizeof(AES_Block)), offsets[i]
+            );
+
+        status = box->ops->decrypt_blocks(
+            blocks, batch_len, &box->decryption_keys, blocks, err_details
         );
         if (aes_is_error(status))
             return status;
 
-        *dest_size -= padding_size;
-        return status;
+        for (size_t i = 0; i < batch_len; ++i) {
+            const AES_Block output = aes_xor_blocks(blocks[i], offsets[i]);
+            checksum = aes_xor_blocks(checksum, output);
+            aes_store_block((char*)dest + i * sizeof(AES_Block), output);
+        }
+
+        box->ocb.index += batch_len;
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        numof_blocks -= batch_len;
     }
+
+    box->ocb.offset = offset;
+    box->ocb.checksum = checksum;
+    return status;
+}
+
+typedef AES_BoxEncryptBlocksInMode AES_BoxDecryptBlocksInMode;
+
+static AES_BoxDecryptBlocksInMode aes_box_decrypt_blocks_in_mode[] = {
+    &aes_box_decrypt_blocks_ecb,
+    &aes_box_decrypt_blocks_cbc,
+    &aes_box_decrypt_blocks_cfb,
+    &aes_box_encrypt_blocks_ofb,
+    &aes_box_encrypt_blocks_ctr,
+    &aes_box_decrypt_blocks_gcm,
+    &aes_box_decrypt_blocks_xts,
+    &aes_box_decrypt_blocks_ccm,
+    &aes_box_decrypt_blocks_ocb,
+    &aes_box_encrypt_blocks_gcm_siv,
+};
+
+/* The counter is 32-bit, so a message can't be longer than 2^32 - 2 blocks. */
+#define AES_BOX_GCM_MAX_SIZE ((((unsigned long long)1 << 32) - 2) * sizeof(AES_Block))
+
+/* The last partial block is zero-padded before it's hashed. */
+static AES_StatusCode aes_box_encrypt_partial_block_gcm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+
+    status = aes_box_encrypt_blocks_ctr(box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memset(block + src_size, 0x00, sizeof(block) - src_size);
+    box->gcm.hash = box->gcm.ops->ghash(box->gcm.hash, block, 1, &box->gcm.key);
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_partial_block_gcm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+
+    box->gcm.hash = box->gcm.ops->ghash(box->gcm.hash, block, 1, &box->gcm.key);
+
+    status = aes_box_encrypt_blocks_ctr(box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+/* Hashes the lengths & encrypts the hash, which produces the tag.
+ * The AAD is reset for the next message. */
+static AES_StatusCode aes_box_finish_gcm(
+    AES_Box* box,
+    size_t data_size,
+    AES_Block* tag,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    const unsigned long long aad_bits = (unsigned long long)box->gcm.aad_size * 8;
+    const unsigned long long data_bits = (unsigned long long)data_size * 8;
+
+    AES_ALIGN(unsigned char, 16) lengths[16];
+    for (int i = 0; i < 8; ++i) {
+        lengths[7 - i] = (unsigned char)(aad_bits >> (8 * i));
+        lengths[15 - i] = (unsigned char)(data_bits >> (8 * i));
+    }
+
+    const AES_Block hash = box->gcm.ops->ghash(box->gcm.hash, lengths, 1, &box->gcm.key);
+
+    box->gcm.hash = _mm_setzero_si128();
+    box->gcm.aad_size = 0;
+
+    status = box->ops->encrypt_block(&box->gcm.j0, &box->encryption_keys, tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    *tag = aes_xor_blocks(*tag, hash);
+    return status;
+}
+
+/* Checks every byte, so that the time doesn't depend on where the tags
+ * differ. */
+static int aes_box_tags_equal(AES_Block a, AES_Block b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xffff;
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_gcm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    /* The counter starts right after J0 for every message. */
+    box->iv = aes_inc_block(box->gcm.j0);
+
+    status = aes_box_encrypt_blocks_gcm(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    src = (const char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    status = aes_box_encrypt_partial_block_gcm(box, src, src_size % block_size, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_gcm(box, src_size, &box->tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block((char*)dest + src_size % block_size, box->tag);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_gcm(
+    AES_Box* box,
+    const void* src,
+    size_t dest_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = dest_size / block_size;
+
+    const AES_Block expected_tag = aes_load_block((const char*)src + dest_size);
+    AES_Block tag;
+
+    box->iv = aes_inc_block(box->gcm.j0);
+
+    status = aes_box_decrypt_blocks_gcm(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_decrypt_partial_block_gcm(
+        box,
+        (const char*)src + src_len * block_size,
+        dest_size % block_size,
+        (char*)dest + src_len * block_size,
+        err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_gcm(box, dest_size, &tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (!aes_box_tags_equal(tag, expected_tag)) {
+        memset(dest, 0x00, dest_size);
+        return aes_error_authentication(err_details);
+    }
+
+    box->tag = tag;
+    return status;
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_xts(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweak;
+
+    status = box->ops->encrypt_block(&box->iv, &box->xts.tweak_keys, &tweak, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    return aes_box_encrypt_data_unit_xts(box, src, src_size, tweak, dest, err_details);
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_xts(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweak;
+
+    status = box->ops->encrypt_block(&box->iv, &box->xts.tweak_keys, &tweak, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    return aes_box_decrypt_data_unit_xts(box, src, src_size, tweak, dest, err_details);
+}
+
+/* The counter is 15 - nonce_size bytes long, and it's incremented as a 32-bit
+ * number. */
+static unsigned long long aes_box_get_max_size_ccm(const AES_Box* box) {
+    const size_t q = 15 - box->ccm.nonce_size;
+
+    if (q < 5)
+        return ((unsigned long long)1 << (8 * q)) - 1;
+    return (((unsigned long long)1 << 32) - 1) * sizeof(AES_Block);
+}
+
+/* Computes the MAC of B0 & the additional authenticated data, and sets the
+ * counter to A1. */
+static AES_StatusCode aes_box_start_ccm(
+    AES_Box* box,
+    size_t data_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    const size_t q = 15 - box->ccm.nonce_size;
+    AES_ALIGN(unsigned char, 16) block[16];
+    AES_Block mac;
+
+    /* B0 = flags || nonce || data size */
+    aes_store_block_aligned(block, box->ccm.a0);
+    block[0] = (unsigned char)((box->ccm.aad_size != 0 ? 0x40 : 0x00) |
+                               ((box->ccm.tag_size - 2) / 2) << 3 | (q - 1));
+    unsigned long long size = data_size;
+    for (size_t i = 0; i < q; ++i, size >>= 8)
+        block[15 - i] = (unsigned char)size;
+
+    mac = aes_load_block_aligned(block);
+    status = box->ops->encrypt_block(&mac, &box->encryption_keys, &mac, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    box->iv = aes_inc_block(box->ccm.a0);
+
+    if (box->ccm.aad_size == 0) {
+        box->ccm.mac = mac;
+        return status;
+    }
+
+    /* The AAD is prefixed with its size: 2 bytes if it's less than 2^16 - 2^8,
+     * 0xfffe & 4 bytes if it's less than 2^32, 0xffff & 8 bytes otherwise.
+     * Then it's zero-padded to a whole number of blocks. */
+    unsigned long long aad_size = box->ccm.aad_size;
+    size_t prefix_size = 0, used = 2;
+
+    if (aad_size >= 0xff00) {
+        block[0] = 0xff;
+        block[1] = aad_size <= 0xffffffff ? 0xfe : 0xff;
+        prefix_size = 2;
+        used = aad_size <= 0xffffffff ? 6 : 10;
+    }
+    for (size_t i = used; i > prefix_size; --i, aad_size >>= 8)
+        block[i - 1] = (unsigned char)aad_size;
+
+    const unsigned char* aad = (const unsigned char*)box->ccm.aad;
+    size_t remaining = box->ccm.aad_size;
+
+    for (;;) {
+        const size_t n = remaining < sizeof(block) - used ? remaining : sizeof(block) - used;
+
+        memcpy(block + used, aad, n);
+        memset(block + used + n, 0x00, sizeof(block) - used - n);
+        aad += n;
+        remaining -= n;
+
+        mac = aes_xor_blocks(mac, aes_load_block_aligned(block));
+        status = box->ops->encrypt_block(&mac, &box->encryption_keys, &mac, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        if (remaining == 0)
+            break;
+        used = 0;
+    }
+
+    box->ccm.mac = mac;
+    return status;
+}
+
+/* The last partial block is zero-padded before it's MACed. */
+static AES_StatusCode aes_box_encrypt_partial_block_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+
+    status = aes_box_encrypt_blocks_ccm(box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_partial_block_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    AES_Block keystream;
+
+    status = box->ops->encrypt_block(&box->iv, &box->encryption_keys, &keystream, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+    aes_store_block_aligned(block, aes_xor_blocks(aes_load_block_aligned(block), keystream));
+    memset(block + src_size, 0x00, sizeof(block) - src_size);
+    memcpy(dest, block, src_size);
+
+    const AES_Block mac = aes_xor_blocks(box->ccm.mac, aes_load_block_aligned(block));
+    return box->ops->encrypt_block(&mac, &box->encryption_keys, &box->ccm.mac, err_details);
+}
+
+/* The tag is the MAC encrypted using A0, truncated to tag_size bytes (the rest
+ * are zeroed).
+ * The AAD is reset for the next message. */
+static AES_StatusCode aes_box_finish_ccm(
+    AES_Box* box,
+    AES_Block* tag,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_ALIGN(unsigned char, 16) block[16];
+
+    box->ccm.aad = NULL;
+    box->ccm.aad_size = 0;
+
+    status = box->ops->encrypt_block(&box->ccm.a0, &box->encryption_keys, tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block_aligned(block, aes_xor_blocks(*tag, box->ccm.mac));
+    memset(block + box->ccm.tag_size, 0x00, sizeof(block) - box->ccm.tag_size);
+    *tag = aes_load_block_aligned(block);
+    return status;
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    status = aes_box_start_ccm(box, src_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_encrypt_blocks_ccm(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    src = (const char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    status = aes_box_encrypt_partial_block_ccm(box, src, src_size % block_size, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_ccm(box, &box->tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    AES_ALIGN(unsigned char, 16) tag[16];
+    aes_store_block_aligned(tag, box->tag);
+    memcpy((char*)dest + src_size % block_size, tag, box->ccm.tag_size);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_ccm(
+    AES_Box* box,
+    const void* src,
+    size_t dest_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = dest_size / block_size;
+
+    AES_ALIGN(unsigned char, 16) expected_tag[16];
+    memset(expected_tag, 0x00, sizeof(expected_tag));
+    memcpy(expected_tag, (const char*)src + dest_size, box->ccm.tag_size);
+    AES_Block tag;
+
+    status = aes_box_start_ccm(box, dest_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_decrypt_blocks_ccm(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_decrypt_partial_block_ccm(
+        box,
+        (const char*)src + src_len * block_size,
+        dest_size % block_size,
+        (char*)dest + src_len * block_size,
+        err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_ccm(box, &tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (!aes_box_tags_equal(tag, aes_load_block_aligned(expected_tag))) {
+        memset(dest, 0x00, dest_size);
+        return aes_error_authentication(err_details);
+    }
+
+    box->tag = tag;
+    return status;
+}
+
+/* See AES_BOX_OCB_NUMOF_L. */
+#define AES_BOX_OCB_MAX_SIZE ((((unsigned long long)1 << 32) - 1) * sizeof(AES_Block))
+
+/* HASH(K, A) is computed the same way the ciphertext is, except that the
+ * encrypted blocks are XORed together. */
+static AES_StatusCode aes_box_hash_ocb(
+    AES_Box* box,
+    const void* aad,
+    size_t aad_size,
+    AES_Block* hash,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block offsets[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    AES_Block offset = _mm_setzero_si128();
+    AES_Block sum = _mm_setzero_si128();
+    unsigned long long index = 0;
+
+    size_t block_size = sizeof(AES_Block);
+    size_t numof_blocks = aad_size / block_size;
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        offset = aes_box_fill_offsets_ocb(&box->ocb, offsets, batch_len, index, offset);
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)aad + i * block_size), offsets[i]
+            );
+
+        status = box->ops->encrypt_blocks(
+            blocks, batch_len, &box->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            sum = aes_xor_blocks(sum, blocks[i]);
+
+        index += batch_len;
+        aad = (const char*)aad + batch_len * block_size;
+        numof_blocks -= batch_len;
+    }
+
+    if (aad_size % block_size != 0) {
+        AES_ALIGN(unsigned char, 16) block[16];
+        memset(block, 0x00, sizeof(block));
+        memcpy(block, aad, aad_size % block_size);
+        block[aad_size % block_size] = 0x80;
+
+        offset = aes_xor_blocks(offset, box->ocb.l_star);
+        AES_Block input = aes_xor_blocks(aes_load_block_aligned(block), offset);
+
+        status = box->ops->encrypt_block(&input, &box->encryption_keys, &input, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        sum = aes_xor_blocks(sum, input);
+    }
+
+    *hash = sum;
+    return status;
+}
+
+/* The last partial block is XORed with E(Offset_*), and it's padded with 10*
+ * before it's added to the checksum. */
+static AES_StatusCode aes_box_encrypt_partial_block_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    AES_Block pad;
+
+    box->ocb.offset = aes_xor_blocks(box->ocb.offset, box->ocb.l_star);
+
+    status = box->ops->encrypt_block(&box->ocb.offset, &box->encryption_keys, &pad, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+    block[src_size] = 0x80;
+
+    const AES_Block input = aes_load_block_aligned(block);
+    box->ocb.checksum = aes_xor_blocks(box->ocb.checksum, input);
+
+    aes_store_block_aligned(block, aes_xor_blocks(input, pad));
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_partial_block_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    AES_Block pad;
+
+    box->ocb.offset = aes_xor_blocks(box->ocb.offset, box->ocb.l_star);
+
+    status = box->ops->encrypt_block(&box->ocb.offset, &box->encryption_keys, &pad, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+    aes_store_block_aligned(block, aes_xor_blocks(aes_load_block_aligned(block), pad));
+    memset(block + src_size, 0x00, sizeof(block) - src_size);
+    block[src_size] = 0x80;
+
+    box->ocb.checksum = aes_xor_blocks(box->ocb.checksum, aes_load_block_aligned(block));
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+/* Tag = E(Checksum ^ Offset ^ L_$) ^ HASH(K, A).
+ * The AAD is reset for the next message. */
+static AES_StatusCode aes_box_finish_ocb(
+    AES_Box* box,
+    AES_Block* tag,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    const AES_Block hash = box->ocb.hash;
+    const AES_Block block = aes_xor_blocks(
+        aes_xor_blocks(box->ocb.checksum, box->ocb.offset), box->ocb.l_dollar
+    );
+
+    box->ocb.hash = _mm_setzero_si128();
+
+    status = box->ops->encrypt_block(&block, &box->encryption_keys, tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    *tag = aes_xor_blocks(*tag, hash);
+    return status;
+}
+
+static void aes_box_start_ocb(AES_Box* box) {
+    box->ocb.offset = box->ocb.offset0;
+    box->ocb.checksum = _mm_setzero_si128();
+    box->ocb.index = 0;
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    aes_box_start_ocb(box);
+
+    status = aes_box_encrypt_blocks_ocb(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    src = (const char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    status = aes_box_encrypt_partial_block_ocb(box, src, src_size % block_size, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_ocb(box, &box->tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block((char*)dest + src_size % block_size, box->tag);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_ocb(
+    AES_Box* box,
+    const void* src,
+    size_t dest_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = dest_size / block_size;
+
+    const AES_Block expected_tag = aes_load_block((const char*)src + dest_size);
+    AES_Block tag;
+
+    aes_box_start_ocb(box);
+
+    status = aes_box_decrypt_blocks_ocb(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_decrypt_partial_block_ocb(
+        box,
+        (const char*)src + src_len * block_size,
+        dest_size % block_size,
+        (char*)dest + src_len * block_size,
+        err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_finish_ocb(box, &tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (!aes_box_tags_equal(tag, expected_tag)) {
+        memset(dest, 0x00, dest_size);
+        return aes_error_authentication(err_details);
+    }
+
+    box->tag = tag;
+    return status;
+}
+
+/* Both the plaintext & the additional authenticated data are limited to 2^36
+ * bytes. */
+#define AES_BOX_GCM_SIV_MAX_SIZE ((unsigned long long)1 << 36)
+
+/* Multiplies the block by x in GHASH's bit order. */
+static AES_Block aes_box_mulx_gcm_siv(AES_Block block) {
+    AES_ALIGN(unsigned char, 16) bytes[16];
+    aes_store_block_aligned(bytes, block);
+
+    const unsigned char carry = bytes[15] & 1;
+    for (int i = 15; i > 0; --i)
+        bytes[i] = (unsigned char)(bytes[i] >> 1 | bytes[i - 1] << 7);
+    bytes[0] = (unsigned char)(bytes[0] >> 1 ^ carry * 0xe1);
+
+    return aes_load_block_aligned(bytes);
+}
+
+/* The keys for the message are derived by encrypting LE32(i) || nonce & taking
+ * the first half of every block: two blocks for the POLYVAL key, two (AES-128)
+ * or four (AES-256) for the encryption key.
+ * All of the blocks are encrypted at once. */
+static AES_StatusCode aes_box_derive_keys_gcm_siv(AES_Box* box, AES_ErrorDetails* err_details) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block blocks[6];
+    AES_Key key;
+    AES_DecryptionRoundKeys decryption_keys;
+
+    const size_t numof_blocks = box->algorithm == AES_AES128 ? 4 : 6;
+    const AES_Block nonce = _mm_slli_si128(box->iv, 4);
+
+    for (size_t i = 0; i < numof_blocks; ++i)
+        blocks[i] = _mm_or_si128(nonce, aes_make_block(0, 0, 0, (int)i));
+
+    status = box->ops->encrypt_blocks(
+        blocks, numof_blocks, &box->encryption_keys, blocks, err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    if (box->algorithm == AES_AES128) {
+        key.aes128_key.key = _mm_unpacklo_epi64(blocks[2], blocks[3]);
+    } else {
+        key.aes256_key.lo = _mm_unpacklo_epi64(blocks[2], blocks[3]);
+        key.aes256_key.hi = _mm_unpacklo_epi64(blocks[4], blocks[5]);
+    }
+
+    status = box->ops->expand_key(
+        &key, &box->gcm_siv.encryption_keys, &decryption_keys, err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    /* POLYVAL(H, X) = ByteReverse(GHASH(mulX_GHASH(ByteReverse(H)), ByteReverse(X)))
+     * (see RFC 8452, appendix A), so GHASH is used with a modified key. */
+    const AES_Block h = _mm_unpacklo_epi64(blocks[0], blocks[1]);
+    box->gcm_siv.ops->init_key(&box->gcm_siv.key, aes_box_mulx_gcm_siv(aes_reverse_byte_order(h)));
+    return status;
+}
+
+/* The blocks are byte-reversed a batch at a time before they're hashed, the
+ * hash value is kept in GHASH's byte order.
+ * The last partial block is zero-padded. */
+static AES_Block aes_box_polyval_gcm_siv(
+    const AES_Box* box,
+    AES_Block hash,
+    const void* src,
+    size_t src_size
+) {
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    size_t block_size = sizeof(AES_Block);
+    size_t numof_blocks = src_size / block_size;
+
+    while (numof_blocks > 0) {
+        const size_t batch_len = numof_blocks < AES_BOX_BATCH_LEN ? numof_blocks
+                                                                  : AES_BOX_BATCH_LEN;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_reverse_byte_order(aes_load_block((const char*)src + i * block_size));
+
+        hash = box->gcm_siv.ops->ghash(hash, blocks, batch_len, &box->gcm_siv.key);
+
+        src = (const char*)src + batch_len * block_size;
+        numof_blocks -= batch_len;
+    }
+
+    if (src_size % block_size != 0) {
+        AES_ALIGN(unsigned char, 16) block[16];
+        memset(block, 0x00, sizeof(block));
+        memcpy(block, src, src_size % block_size);
+        blocks[0] = aes_reverse_byte_order(aes_load_block_aligned(block));
+        hash = box->gcm_siv.ops->ghash(hash, blocks, 1, &box->gcm_siv.key);
+    }
+
+    return hash;
+}
+
+/* Tag = E(S_s ^ nonce, with the top bit cleared), S_s being the POLYVAL of the
+ * padded AAD, the padded plaintext & their sizes in bits.
+ * The AAD is reset for the next message. */
+static AES_StatusCode aes_box_finish_gcm_siv(
+    AES_Box* box,
+    AES_Block hash,
+    size_t plaintext_size,
+    AES_Block* tag,
+    AES_ErrorDetails* err_details
+) {
+    const unsigned long long aad_bits = (unsigned long long)box->gcm_siv.aad_size * 8;
+    const unsigned long long data_bits = (unsigned long long)plaintext_size * 8;
+
+    const AES_Block lengths = aes_reverse_byte_order(aes_make_block(
+        (int)(data_bits >> 32), (int)data_bits, (int)(aad_bits >> 32), (int)aad_bits
+    ));
+    hash = box->gcm_siv.ops->ghash(hash, &lengths, 1, &box->gcm_siv.key);
+
+    box->gcm_siv.aad = NULL;
+    box->gcm_siv.aad_size = 0;
+
+    AES_Block block = aes_xor_blocks(
+        aes_reverse_byte_order(hash), _mm_and_si128(box->iv, aes_make_block(0, -1, -1, -1))
+    );
+    block = _mm_and_si128(block, aes_make_block(0x7fffffff, -1, -1, -1));
+
+    return box->ops->encrypt_block(&block, &box->gcm_siv.encryption_keys, tag, err_details);
+}
+
+static AES_StatusCode aes_box_get_tag_gcm_siv(
+    AES_Box* box,
+    const void* plaintext,
+    size_t plaintext_size,
+    AES_Block* tag,
+    AES_ErrorDetails* err_details
+) {
+    AES_Block hash = _mm_setzero_si128();
+    hash = aes_box_polyval_gcm_siv(box, hash, box->gcm_siv.aad, box->gcm_siv.aad_size);
+    hash = aes_box_polyval_gcm_siv(box, hash, plaintext, plaintext_size);
+
+    return aes_box_finish_gcm_siv(box, hash, plaintext_size, tag, err_details);
+}
+
+/* The initial counter block is the tag with the top bit set. */
+static AES_StatusCode aes_box_apply_keystream_gcm_siv(
+    AES_Box* box,
+    AES_Block tag,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    box->gcm_siv.counter = _mm_or_si128(tag, aes_make_block((int)0x80000000, 0, 0, 0));
+
+    status = aes_box_encrypt_blocks_gcm_siv(box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (src_size % block_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, (const char*)src + src_len * block_size, src_size % block_size);
+
+    status = aes_box_encrypt_blocks_gcm_siv(box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memcpy((char*)dest + src_len * block_size, block, src_size % block_size);
+    return status;
+}
+
+/* The tag is computed from the plaintext, and then it's used as the IV, so the
+ * plaintext is read twice. */
+static AES_StatusCode aes_box_encrypt_buffer_gcm_siv(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    status = aes_box_derive_keys_gcm_siv(box, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_get_tag_gcm_siv(box, src, src_size, &box->tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_apply_keystream_gcm_siv(box, box->tag, src, src_size, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_store_block((char*)dest + src_size, box->tag);
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_gcm_siv(
+    AES_Box* box,
+    const void* src,
+    size_t dest_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    const AES_Block expected_tag = aes_load_block((const char*)src + dest_size);
+    AES_Block tag;
+
+    status = aes_box_derive_keys_gcm_siv(box, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_apply_keystream_gcm_siv(box, expected_tag, src, dest_size, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_get_tag_gcm_siv(box, dest, dest_size, &tag, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (!aes_box_tags_equal(tag, expected_tag)) {
+        memset(dest, 0x00, dest_size);
+        return aes_error_authentication(err_details);
+    }
+
+    box->tag = tag;
+    return status;
+}
+
+static AES_StatusCode aes_box_get_encrypted_buffer_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    size_t* padding_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC: {
+            size_t block_size = sizeof(AES_Block);
+            *padding_size = block_size - src_size % block_size;
+            *dest_size = src_size + *padding_size;
+            return status;
+        }
+
+        case AES_CFB:
+        case AES_OFB:
+        case AES_CTR:
+            *dest_size = src_size;
+            *padding_size = 0;
+            return status;
+
+        case AES_GCM:
+            if ((unsigned long long)src_size > AES_BOX_GCM_MAX_SIZE)
+                return aes_error_not_implemented(err_details, "GCM messages are limited to 64 GiB");
+
+            *dest_size = src_size + AES_BOX_TAG_SIZE;
+            *padding_size = 0;
+            return status;
+
+        case AES_GCM_SIV:
+            if ((unsigned long long)src_size > AES_BOX_GCM_SIV_MAX_SIZE)
+                return aes_error_not_implemented(
+                    err_details, "GCM-SIV messages are limited to 64 GiB"
+                );
+
+            *dest_size = src_size + AES_BOX_TAG_SIZE;
+            *padding_size = 0;
+            return status;
+
+        case AES_XTS:
+            if (src_size < sizeof(AES_Block))
+                return aes_error_not_implemented(err_details, "XTS requires at least one block");
+
+            *dest_size = src_size;
+            *padding_size = 0;
+            return status;
+
+        case AES_CCM:
+            if ((unsigned long long)src_size > aes_box_get_max_size_ccm(box))
+                return aes_error_not_implemented(
+                    err_details, "the CCM message is too long for the nonce size"
+                );
+
+            *dest_size = src_size + box->ccm.tag_size;
+            *padding_size = 0;
+            return status;
+
+        case AES_OCB:
+            if ((unsigned long long)src_size > AES_BOX_OCB_MAX_SIZE)
+                return aes_error_not_implemented(err_details, "OCB messages are limited to 64 GiB");
+
+            *dest_size = src_size + AES_BOX_TAG_SIZE;
+            *padding_size = 0;
+            return status;
+
+        default:
+            return aes_error_not_implemented(err_details, "unsupported mode of operation");
+    }
+}
+
+AES_StatusCode aes_box_encrypted_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    size_t padding_size = 0;
+    return aes_box_get_encrypted_buffer_size(box, src_size, dest_size, &padding_size, err_details);
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_partial_block_with_padding(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t padding_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memcpy(block, src, src_size);
+
+    status = aes_fill_with_padding(AES_PADDING_PKCS7, block + src_size, padding_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    return aes_box_encrypt_blocks_in_mode[box->mode](box, block, 1, dest, err_details);
+}
+
+static AES_StatusCode aes_box_encrypt_buffer_partial_block(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+
+    status = aes_box_encrypt_blocks_in_mode[box->mode](box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+AES_StatusCode aes_box_encrypt_buffer(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    size_t padding_size = 0;
+
+    status =
+        aes_box_get_encrypted_buffer_size(box, src_size, dest_size, &padding_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (dest == NULL)
+        return AES_SUCCESS;
+    if (src == NULL && src_size != 0)
+        return aes_error_null_argument(err_details, "src");
+
+    if (box->mode == AES_GCM)
+        return aes_box_encrypt_buffer_gcm(box, src, src_size, dest, err_details);
+    if (box->mode == AES_XTS)
+        return aes_box_encrypt_buffer_xts(box, src, src_size, dest, err_details);
+    if (box->mode == AES_CCM)
+        return aes_box_encrypt_buffer_ccm(box, src, src_size, dest, err_details);
+    if (box->mode == AES_OCB)
+        return aes_box_encrypt_buffer_ocb(box, src, src_size, dest, err_details);
+    if (box->mode == AES_GCM_SIV)
+        return aes_box_encrypt_buffer_gcm_siv(box, src, src_size, dest, err_details);
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    status = aes_box_encrypt_blocks_in_mode[box->mode](box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    src = (char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    if (padding_size == 0)
+        return aes_box_encrypt_buffer_partial_block(
+            box, src, src_size % block_size, dest, err_details
+        );
+    else
+        return aes_box_encrypt_buffer_partial_block_with_padding(
+            box, src, src_size % block_size, dest, padding_size, err_details
+        );
+}
+
+static AES_StatusCode aes_box_get_decrypted_buffer_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    size_t* max_padding_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC: {
+            size_t block_size = sizeof(AES_Block);
+
+            if (src_size == 0 || src_size % block_size != 0)
+                return aes_error_missing_padding(err_details);
+
+            *dest_size = src_size;
+            *max_padding_size = block_size;
+            return status;
+        }
+
+        case AES_CFB:
+        case AES_OFB:
+        case AES_CTR:
+            *dest_size = src_size;
+            *max_padding_size = 0;
+            return status;
+
+        case AES_GCM:
+            if (src_size < AES_BOX_TAG_SIZE)
+                return aes_error_authentication(err_details);
+            if ((unsigned long long)(src_size - AES_BOX_TAG_SIZE) > AES_BOX_GCM_MAX_SIZE)
+                return aes_error_not_implemented(err_details, "GCM messages are limited to 64 GiB");
+
+            *dest_size = src_size - AES_BOX_TAG_SIZE;
+            *max_padding_size = 0;
+            return status;
+
+        case AES_GCM_SIV:
+            if (src_size < AES_BOX_TAG_SIZE)
+                return aes_error_authentication(err_details);
+            if ((unsigned long long)(src_size - AES_BOX_TAG_SIZE) > AES_BOX_GCM_SIV_MAX_SIZE)
+                return aes_error_not_implemented(
+                    err_details, "GCM-SIV messages are limited to 64 GiB"
+                );
+
+            *dest_size = src_size - AES_BOX_TAG_SIZE;
+            *max_padding_size = 0;
+            return status;
+
+        case AES_XTS:
+            if (src_size < sizeof(AES_Block))
+                return aes_error_not_implemented(err_details, "XTS requires at least one block");
+
+            *dest_size = src_size;
+            *max_padding_size = 0;
+            return status;
+
+        case AES_CCM:
+            if (src_size < box->ccm.tag_size)
+                return aes_error_authentication(err_details);
+            if ((unsigned long long)(src_size - box->ccm.tag_size) > aes_box_get_max_size_ccm(box))
+                return aes_error_not_implemented(
+                    err_details, "the CCM message is too long for the nonce size"
+                );
+
+            *dest_size = src_size - box->ccm.tag_size;
+            *max_padding_size = 0;
+            return status;
+
+        case AES_OCB:
+            if (src_size < AES_BOX_TAG_SIZE)
+                return aes_error_authentication(err_details);
+            if ((unsigned long long)(src_size - AES_BOX_TAG_SIZE) > AES_BOX_OCB_MAX_SIZE)
+                return aes_error_not_implemented(err_details, "OCB messages are limited to 64 GiB");
+
+            *dest_size = src_size - AES_BOX_TAG_SIZE;
+            *max_padding_size = 0;
+            return status;
+
+        default:
+            return aes_error_not_implemented(err_details, "unsupported mode of operation");
+    }
+}
+
+AES_StatusCode aes_box_max_decrypted_size(
+    const AES_Box* box,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    size_t max_padding_size = 0;
+    return aes_box_get_decrypted_buffer_size(
+        box, src_size, dest_size, &max_padding_size, err_details
+    );
+}
+
+static AES_StatusCode aes_box_decrypt_buffer_partial_block(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (src_size == 0)
+        return status;
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    memcpy(block, src, src_size);
+
+    status = aes_box_decrypt_blocks_in_mode[box->mode](box, block, 1, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    memcpy(dest, block, src_size);
+    return status;
+}
+
+AES_StatusCode aes_box_decrypt_buffer(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    AES_StatusCode status = AES_SUCCESS;
+    size_t max_padding_size = 0;
+
+    status =
+        aes_box_get_decrypted_buffer_size(box, src_size, dest_size, &max_padding_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (dest == NULL)
+        return AES_SUCCESS;
+    if (src == NULL)
+        return aes_error_null_argument(err_details, "src");
+
+    if (box->mode == AES_GCM)
+        return aes_box_decrypt_buffer_gcm(box, src, *dest_size, dest, err_details);
+    if (box->mode == AES_XTS)
+        return aes_box_decrypt_buffer_xts(box, src, src_size, dest, err_details);
+    if (box->mode == AES_CCM)
+        return aes_box_decrypt_buffer_ccm(box, src, *dest_size, dest, err_details);
+    if (box->mode == AES_OCB)
+        return aes_box_decrypt_buffer_ocb(box, src, *dest_size, dest, err_details);
+    if (box->mode == AES_GCM_SIV)
+        return aes_box_decrypt_buffer_gcm_siv(box, src, *dest_size, dest, err_details);
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t src_len = src_size / block_size;
+
+    status = aes_box_decrypt_blocks_in_mode[box->mode](box, src, src_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    src = (char*)src + src_len * block_size;
+    dest = (char*)dest + src_len * block_size;
+
+    if (max_padding_size == 0) {
+        return aes_box_decrypt_buffer_partial_block(
+            box, src, src_size % block_size, dest, err_details
+        );
+    } else {
+        size_t padding_size;
+
+        status = aes_extract_padding_size(
+            AES_PADDING_PKCS7, (char*)dest - block_size, block_size, &padding_size, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        *dest_size -= padding_size;
+        return status;
+    }
+}
+
+AES_StatusCode aes_box_encrypt_inplace(
+    AES_Box* box,
+    void* buf,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (buf == NULL)
+        return aes_error_null_argument(err_details, "buf");
+
+    return aes_box_encrypt_buffer(box, buf, src_size, buf, dest_size, err_details);
+}
+
+AES_StatusCode aes_box_decrypt_inplace(
+    AES_Box* box,
+    void* buf,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (buf == NULL)
+        return aes_error_null_argument(err_details, "buf");
+
+    return aes_box_decrypt_buffer(box, buf, src_size, buf, dest_size, err_details);
+}
+
+static AES_StatusCode aes_box_start_stream(AES_Box* box, AES_ErrorDetails* err_details) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box->stream.started)
+        return status;
+
+    switch (box->mode) {
+        case AES_GCM:
+            box->iv = aes_inc_block(box->gcm.j0);
+            break;
+
+        case AES_XTS:
+            status = box->ops->encrypt_block(
+                &box->iv, &box->xts.tweak_keys, &box->xts.tweak, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+            break;
+
+        case AES_OCB:
+            aes_box_start_ocb(box);
+            break;
+
+        case AES_CCM:
+        case AES_GCM_SIV:
+            return aes_error_not_implemented(
+                err_details, "CCM and GCM-SIV messages can't be processed in chunks"
+            );
+
+        default:
+            break;
+    }
+
+    box->stream.buffer_size = 0;
+    box->stream.message_size = 0;
+    box->stream.started = 1;
+    return status;
+}
+
+/* The number of bytes at the end of the input that can only be processed once
+ * the message is complete. */
+static size_t aes_box_get_withheld_size(const AES_Box* box, int decrypt) {
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC:
+            /* The last block, which is padded, might be complete. */
+            return decrypt ? 1 : 0;
+
+        case AES_GCM:
+        case AES_OCB:
+            return decrypt ? AES_BOX_TAG_SIZE : 0;
+
+        case AES_XTS:
+            return sizeof(AES_Block);
+
+        default:
+            return 0;
+    }
+}
+
+static AES_StatusCode aes_box_check_stream_size(
+    AES_Box* box,
+    unsigned long long message_size,
+    AES_ErrorDetails* err_details
+) {
+    if (box->mode == AES_GCM && message_size > AES_BOX_GCM_MAX_SIZE)
+        return aes_error_not_implemented(err_details, "GCM messages are limited to 64 GiB");
+    if (box->mode == AES_OCB && message_size > AES_BOX_OCB_MAX_SIZE)
+        return aes_error_not_implemented(err_details, "OCB messages are limited to 64 GiB");
+    return AES_SUCCESS;
+}
+
+/* In XTS mode, the tweak is carried over from the previous blocks of the data
+ * unit instead of being computed from the init vector. */
+static AES_StatusCode aes_box_encrypt_next_blocks(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    if (box->mode == AES_XTS)
+        return aes_box_encrypt_tweaked_blocks_xts(
+            box, src, numof_blocks, dest, &box->xts.tweak, err_details
+        );
+    return aes_box_encrypt_blocks_in_mode[box->mode](box, src, numof_blocks, dest, err_details);
+}
+
+static AES_StatusCode aes_box_decrypt_next_blocks(
+    AES_Box* box,
+    const void* src,
+    size_t numof_blocks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    if (box->mode == AES_XTS)
+        return aes_box_decrypt_tweaked_blocks_xts(
+            box, src, numof_blocks, dest, &box->xts.tweak, err_details
+        );
+    return aes_box_decrypt_blocks_in_mode[box->mode](box, src, numof_blocks, dest, err_details);
+}
+
+/* Processes every complete block that isn't withheld, the buffered ones
+ * first, and buffers the rest of the input. */
+static AES_StatusCode aes_box_update(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* written,
+    int decrypt,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    *written = 0;
+
+    status = aes_box_start_stream(box, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    const AES_BoxEncryptBlocksInMode process_blocks =
+        decrypt ? &aes_box_decrypt_next_blocks : &aes_box_encrypt_next_blocks;
+
+    size_t block_size = sizeof(AES_Block);
+    unsigned char* buffer = (unsigned char*)box->stream.buffer;
+
+    const size_t withheld_size = aes_box_get_withheld_size(box, decrypt);
+    const size_t available_size = box->stream.buffer_size + src_size;
+    const size_t ready_size = available_size > withheld_size ? available_size - withheld_size : 0;
+
+    status = aes_box_check_stream_size(box, box->stream.message_size + ready_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    size_t numof_blocks = ready_size / block_size;
+    const size_t dest_size = numof_blocks * block_size;
+
+    if (numof_blocks > 0 && box->stream.buffer_size > 0) {
+        size_t buffer_len = (box->stream.buffer_size + block_size - 1) / block_size;
+        if (buffer_len > numof_blocks)
+            buffer_len = numof_blocks;
+
+        if (buffer_len * block_size > box->stream.buffer_size) {
+            const size_t fill_size = buffer_len * block_size - box->stream.buffer_size;
+
+            memcpy(buffer + box->stream.buffer_size, src, fill_size);
+            box->stream.buffer_size += fill_size;
+            src = (const char*)src + fill_size;
+            src_size -= fill_size;
+        }
+
+        status = process_blocks(box, buffer, buffer_len, dest, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        box->stream.buffer_size -= buffer_len * block_size;
+        memmove(buffer, buffer + buffer_len * block_size, box->stream.buffer_size);
+
+        dest = (char*)dest + buffer_len * block_size;
+        numof_blocks -= buffer_len;
+    }
+
+    if (numof_blocks > 0) {
+        status = process_blocks(box, src, numof_blocks, dest, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        src = (const char*)src + numof_blocks * block_size;
+        src_size -= numof_blocks * block_size;
+    }
+
+    memcpy(buffer + box->stream.buffer_size, src, src_size);
+    box->stream.buffer_size += src_size;
+    box->stream.message_size += dest_size;
+
+    *written = dest_size;
+    return status;
+}
+
+AES_StatusCode aes_box_encrypt_update(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (written == NULL)
+        return aes_error_null_argument(err_details, "written");
+    if (src == NULL && src_size != 0)
+        return aes_error_null_argument(err_details, "src");
+    if (dest == NULL && src_size != 0)
+        return aes_error_null_argument(err_details, "dest");
+
+    return aes_box_update(box, src, src_size, dest, written, 0, err_details);
+}
+
+AES_StatusCode aes_box_decrypt_update(
+    AES_Box* box,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (written == NULL)
+        return aes_error_null_argument(err_details, "written");
+    if (src == NULL && src_size != 0)
+        return aes_error_null_argument(err_details, "src");
+    if (dest == NULL && src_size != 0)
+        return aes_error_null_argument(err_details, "dest");
+
+    return aes_box_update(box, src, src_size, dest, written, 1, err_details);
+}
+
+static AES_StatusCode aes_box_encrypt_final_chunk(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    unsigned char* buffer = (unsigned char*)box->stream.buffer;
+    const size_t buffer_size = box->stream.buffer_size;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC:
+            status = aes_fill_with_padding(
+                AES_PADDING_PKCS7, buffer + buffer_size, block_size - buffer_size, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_encrypt_blocks_in_mode[box->mode](box, buffer, 1, dest, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            *written = block_size;
+            return status;
+
+        case AES_GCM:
+            status = aes_box_encrypt_partial_block_gcm(box, buffer, buffer_size, dest, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_gcm(
+                box, box->stream.message_size + buffer_size, &box->tag, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block((char*)dest + buffer_size, box->tag);
+            *written = buffer_size + AES_BOX_TAG_SIZE;
+            return status;
+
+        case AES_OCB:
+            status = aes_box_encrypt_partial_block_ocb(box, buffer, buffer_size, dest, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_ocb(box, &box->tag, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block((char*)dest + buffer_size, box->tag);
+            *written = buffer_size + AES_BOX_TAG_SIZE;
+            return status;
+
+        case AES_XTS:
+            if (buffer_size < block_size)
+                return aes_error_not_implemented(err_details, "XTS requires at least one block");
+
+            status = aes_box_encrypt_data_unit_xts(
+                box, buffer, buffer_size, box->xts.tweak, dest, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            *written = buffer_size;
+            return status;
+
+        default:
+            status =
+                aes_box_encrypt_buffer_partial_block(box, buffer, buffer_size, dest, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            *written = buffer_size;
+            return status;
+    }
+}
+
+static AES_StatusCode aes_box_decrypt_final_chunk(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    unsigned char* buffer = (unsigned char*)box->stream.buffer;
+    const size_t buffer_size = box->stream.buffer_size;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC: {
+            AES_ALIGN(unsigned char, 16) block[16];
+            size_t padding_size;
+
+            if (buffer_size != block_size)
+                return aes_error_missing_padding(err_details);
+
+            status = aes_box_decrypt_blocks_in_mode[box->mode](box, buffer, 1, block, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_extract_padding_size(
+                AES_PADDING_PKCS7, block, block_size, &padding_size, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            memcpy(dest, block, block_size - padding_size);
+            *written = block_size - padding_size;
+            return status;
+        }
+
+        case AES_GCM:
+        case AES_OCB: {
+            AES_Block tag;
+
+            if (buffer_size < AES_BOX_TAG_SIZE)
+                return aes_error_authentication(err_details);
+
+            const size_t data_size = buffer_size - AES_BOX_TAG_SIZE;
+            const AES_Block expected_tag = aes_load_block(buffer + data_size);
+
+            if (box->mode == AES_GCM) {
+                status =
+                    aes_box_decrypt_partial_block_gcm(box, buffer, data_size, dest, err_details);
+                if (aes_is_error(status))
+                    return status;
+
+                status = aes_box_finish_gcm(
+                    box, box->stream.message_size + data_size, &tag, err_details
+                );
+                if (aes_is_error(status))
+                    return status;
+            } else {
+                status =
+                    aes_box_decrypt_partial_block_ocb(box, buffer, data_size, dest, err_details);
+                if (aes_is_error(status))
+                    return status;
+
+                status = aes_box_finish_ocb(box, &tag, err_details);
+                if (aes_is_error(status))
+                    return status;
+            }
+
+            if (!aes_box_tags_equal(tag, expected_tag)) {
+                memset(dest, 0x00, data_size);
+                return aes_error_authentication(err_details);
+            }
+
+            box->tag = tag;
+            *written = data_size;
+            return status;
+        }
+
+        case AES_XTS:
+            if (buffer_size < block_size)
+                return aes_error_not_implemented(err_details, "XTS requires at least one block");
+
+            status = aes_box_decrypt_data_unit_xts(
+                box, buffer, buffer_size, box->xts.tweak, dest, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            *written = buffer_size;
+            return status;
+
+        default:
+            status =
+                aes_box_decrypt_buffer_partial_block(box, buffer, buffer_size, dest, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            *written = buffer_size;
+            return status;
+    }
+}
+
+/* The message is over even if it fails, the next update starts a new one. */
+AES_StatusCode aes_box_encrypt_finalize(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest == NULL)
+        return aes_error_null_argument(err_details, "dest");
+    if (written == NULL)
+        return aes_error_null_argument(err_details, "written");
+
+    *written = 0;
+
+    status = aes_box_start_stream(box, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_encrypt_final_chunk(box, dest, written, err_details);
+    aes_box_reset_stream(box);
+    return status;
+}
+
+AES_StatusCode aes_box_decrypt_finalize(
+    AES_Box* box,
+    void* dest,
+    size_t* written,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest == NULL)
+        return aes_error_null_argument(err_details, "dest");
+    if (written == NULL)
+        return aes_error_null_argument(err_details, "written");
+
+    *written = 0;
+
+    status = aes_box_start_stream(box, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_box_decrypt_final_chunk(box, dest, written, err_details);
+    aes_box_reset_stream(box);
+    return status;
+}
+
+/* A position in a list of segments. */
+typedef struct {
+    const AES_IoVec* iov;
+    size_t numof_segments;
+    size_t index;
+    size_t offset;
+} AES_BoxIovCursor;
+
+static AES_BoxIovCursor aes_box_iov_begin(const AES_IoVec* iov, size_t numof_segments) {
+    AES_BoxIovCursor cursor;
+    cursor.iov = iov;
+    cursor.numof_segments = numof_segments;
+    cursor.index = 0;
+    cursor.offset = 0;
+    return cursor;
+}
+
+static size_t aes_box_iov_get_total_size(const AES_IoVec* iov, size_t numof_segments) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < numof_segments; ++i)
+        total_size += iov[i].size;
+    return total_size;
+}
+
+/* The number of bytes left in the current segment (skipping the empty
+ * ones). */
+static size_t aes_box_iov_get_contiguous_size(AES_BoxIovCursor* cursor) {
+    while (cursor->index < cursor->numof_segments &&
+           cursor->offset == cursor->iov[cursor->index].size) {
+        ++cursor->index;
+        cursor->offset = 0;
+    }
+    if (cursor->index == cursor->numof_segments)
+        return 0;
+    return cursor->iov[cursor->index].size - cursor->offset;
+}
+
+static char* aes_box_iov_get_ptr(const AES_BoxIovCursor* cursor) {
+    return (char*)cursor->iov[cursor->index].base + cursor->offset;
+}
+
+/* Copies size bytes from the segments to dest or from src to the segments (or
+ * just skips them, if both are NULL). */
+static void aes_box_iov_copy(AES_BoxIovCursor* cursor, void* dest, const void* src, size_t size) {
+    while (size > 0) {
+        size_t n = aes_box_iov_get_contiguous_size(cursor);
+        if (n > size)
+            n = size;
+
+        if (dest != NULL) {
+            memcpy(dest, aes_box_iov_get_ptr(cursor), n);
+            dest = (char*)dest + n;
+        }
+        if (src != NULL) {
+            memcpy(aes_box_iov_get_ptr(cursor), src, n);
+            src = (const char*)src + n;
+        }
+
+        cursor->offset += n;
+        size -= n;
+    }
+}
+
+static void aes_box_iov_gather(AES_BoxIovCursor* cursor, void* dest, size_t size) {
+    aes_box_iov_copy(cursor, dest, NULL, size);
+}
+
+static void aes_box_iov_scatter(AES_BoxIovCursor* cursor, const void* src, size_t size) {
+    aes_box_iov_copy(cursor, NULL, src, size);
+}
+
+static void aes_box_iov_skip(AES_BoxIovCursor* cursor, size_t size) {
+    aes_box_iov_copy(cursor, NULL, NULL, size);
+}
+
+static void aes_box_iov_zero(AES_BoxIovCursor cursor, size_t size) {
+    while (size > 0) {
+        size_t n = aes_box_iov_get_contiguous_size(&cursor);
+        if (n > size)
+            n = size;
+
+        memset(aes_box_iov_get_ptr(&cursor), 0x00, n);
+        cursor.offset += n;
+        size -= n;
+    }
+}
+
+/* The blocks that are contiguous in both the source & the destination segments
+ * are processed directly, a block that straddles two segments is copied to
+ * the stack first. */
+static AES_StatusCode aes_box_process_iov_blocks(
+    AES_Box* box,
+    AES_BoxEncryptBlocksInMode process_blocks,
+    AES_BoxIovCursor* src,
+    AES_BoxIovCursor* dest,
+    size_t numof_blocks,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+
+    while (numof_blocks > 0) {
+        const size_t src_size = aes_box_iov_get_contiguous_size(src);
+        const size_t dest_size = aes_box_iov_get_contiguous_size(dest);
+        size_t run_len = (src_size < dest_size ? src_size : dest_size) / block_size;
+
+        if (run_len > numof_blocks)
+            run_len = numof_blocks;
+
+        if (run_len > 0) {
+            status = process_blocks(
+                box, aes_box_iov_get_ptr(src), run_len, aes_box_iov_get_ptr(dest), err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            src->offset += run_len * block_size;
+            dest->offset += run_len * block_size;
+            numof_blocks -= run_len;
+        } else {
+            AES_ALIGN(unsigned char, 16) block[16];
+
+            aes_box_iov_gather(src, block, block_size);
+            status = process_blocks(box, block, 1, block, err_details);
+            if (aes_is_error(status))
+                return status;
+            aes_box_iov_scatter(dest, block, block_size);
+
+            --numof_blocks;
+        }
+    }
+
+    return status;
+}
+
+static AES_Block aes_box_polyval_iov_gcm_siv(
+    const AES_Box* box,
+    AES_Block hash,
+    AES_BoxIovCursor cursor,
+    size_t size
+) {
+    size_t block_size = sizeof(AES_Block);
+    size_t numof_blocks = size / block_size;
+
+    while (numof_blocks > 0) {
+        size_t run_len = aes_box_iov_get_contiguous_size(&cursor) / block_size;
+
+        if (run_len > numof_blocks)
+            run_len = numof_blocks;
+
+        if (run_len > 0) {
+            hash = aes_box_polyval_gcm_siv(
+                box, hash, aes_box_iov_get_ptr(&cursor), run_len * block_size
+            );
+            cursor.offset += run_len * block_size;
+            numof_blocks -= run_len;
+        } else {
+            AES_ALIGN(unsigned char, 16) block[16];
+
+            aes_box_iov_gather(&cursor, block, block_size);
+            hash = aes_box_polyval_gcm_siv(box, hash, block, block_size);
+            --numof_blocks;
+        }
+    }
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    aes_box_iov_gather(&cursor, block, size % block_size);
+    return aes_box_polyval_gcm_siv(box, hash, block, size % block_size);
+}
+
+/* Processes the last partial block & produces the tag in authenticated modes.
+ * The output (at most a block & a tag) is stored in tail. */
+static AES_StatusCode aes_box_encrypt_iov_tail(
+    AES_Box* box,
+    unsigned char* tail,
+    size_t tail_size,
+    size_t src_size,
+    size_t* output_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    *output_size = tail_size;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC:
+            status = aes_fill_with_padding(
+                AES_PADDING_PKCS7, tail + tail_size, block_size - tail_size, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            *output_size = block_size;
+            return aes_box_encrypt_blocks_in_mode[box->mode](box, tail, 1, tail, err_details);
+
+        case AES_GCM:
+            status = aes_box_encrypt_partial_block_gcm(box, tail, tail_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_gcm(box, src_size, &box->tag, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block(tail + tail_size, box->tag);
+            *output_size += AES_BOX_TAG_SIZE;
+            return status;
+
+        case AES_CCM: {
+            AES_ALIGN(unsigned char, 16) tag[16];
+
+            status = aes_box_encrypt_partial_block_ccm(box, tail, tail_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_ccm(box, &box->tag, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block_aligned(tag, box->tag);
+            memcpy(tail + tail_size, tag, box->ccm.tag_size);
+            *output_size += box->ccm.tag_size;
+            return status;
+        }
+
+        case AES_OCB:
+            status = aes_box_encrypt_partial_block_ocb(box, tail, tail_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_ocb(box, &box->tag, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block(tail + tail_size, box->tag);
+            *output_size += AES_BOX_TAG_SIZE;
+            return status;
+
+        case AES_XTS:
+            if (tail_size == 0)
+                return status;
+            return aes_box_encrypt_data_unit_xts(
+                box, tail, tail_size, box->xts.tweak, tail, err_details
+            );
+
+        case AES_GCM_SIV:
+            status = aes_box_encrypt_buffer_partial_block(box, tail, tail_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            aes_store_block(tail + tail_size, box->tag);
+            *output_size += AES_BOX_TAG_SIZE;
+            return status;
+
+        default:
+            return aes_box_encrypt_buffer_partial_block(box, tail, tail_size, tail, err_details);
+    }
+}
+
+static AES_StatusCode aes_box_encrypt_iov_internal(
+    AES_Box* box,
+    AES_BoxIovCursor src,
+    size_t src_size,
+    AES_BoxIovCursor dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    size_t numof_blocks = src_size / block_size;
+    size_t tail_size = src_size % block_size;
+
+    switch (box->mode) {
+        case AES_GCM:
+            box->iv = aes_inc_block(box->gcm.j0);
+            break;
+
+        case AES_XTS:
+            /* The last complete block goes with the partial one. */
+            if (tail_size != 0) {
+                --numof_blocks;
+                tail_size += block_size;
+            }
+
+            status = box->ops->encrypt_block(
+                &box->iv, &box->xts.tweak_keys, &box->xts.tweak, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+            break;
+
+        case AES_CCM:
+            status = aes_box_start_ccm(box, src_size, err_details);
+            if (aes_is_error(status))
+                return status;
+            break;
+
+        case AES_OCB:
+            aes_box_start_ocb(box);
+            break;
+
+        case AES_GCM_SIV: {
+            status = aes_box_derive_keys_gcm_siv(box, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            AES_Block hash = _mm_setzero_si128();
+            hash = aes_box_polyval_gcm_siv(box, hash, box->gcm_siv.aad, box->gcm_siv.aad_size);
+            hash = aes_box_polyval_iov_gcm_siv(box, hash, src, src_size);
+
+            status = aes_box_finish_gcm_siv(box, hash, src_size, &box->tag, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            box->gcm_siv.counter =
+                _mm_or_si128(box->tag, aes_make_block((int)0x80000000, 0, 0, 0));
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    status = aes_box_process_iov_blocks(
+        box, &aes_box_encrypt_next_blocks, &src, &dest, numof_blocks, err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    AES_ALIGN(unsigned char, 16) tail[32];
+    size_t output_size = 0;
+
+    aes_box_iov_gather(&src, tail, tail_size);
+
+    status = aes_box_encrypt_iov_tail(box, tail, tail_size, src_size, &output_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_box_iov_scatter(&dest, tail, output_size);
+    *dest_size = numof_blocks * block_size + output_size;
+    return status;
+}
+
+static size_t aes_box_get_tag_size(const AES_Box* box) {
+    if (box->mode == AES_CCM)
+        return box->ccm.tag_size;
+    if (aes_mode_is_authenticated(box->mode))
+        return AES_BOX_TAG_SIZE;
+    return 0;
+}
+
+/* The tail is the last partial block (in ECB & CBC modes, the last block,
+ * which is padded), followed by the tag. */
+static AES_StatusCode aes_box_decrypt_iov_tail(
+    AES_Box* box,
+    unsigned char* tail,
+    size_t tail_size,
+    size_t dest_size,
+    size_t* output_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t tag_size = aes_box_get_tag_size(box);
+    const size_t data_size = tail_size - tag_size;
+
+    AES_ALIGN(unsigned char, 16) expected_tag[16];
+    memset(expected_tag, 0x00, sizeof(expected_tag));
+    memcpy(expected_tag, tail + data_size, tag_size);
+    AES_Block tag;
+
+    *output_size = data_size;
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC: {
+            size_t padding_size;
+
+            status = aes_box_decrypt_blocks_in_mode[box->mode](box, tail, 1, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_extract_padding_size(
+                AES_PADDING_PKCS7, tail, block_size, &padding_size, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            *output_size -= padding_size;
+            return status;
+        }
+
+        case AES_GCM:
+            status = aes_box_decrypt_partial_block_gcm(box, tail, data_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_gcm(box, dest_size, &tag, err_details);
+            break;
+
+        case AES_CCM:
+            status = aes_box_decrypt_partial_block_ccm(box, tail, data_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_ccm(box, &tag, err_details);
+            break;
+
+        case AES_OCB:
+            status = aes_box_decrypt_partial_block_ocb(box, tail, data_size, tail, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_box_finish_ocb(box, &tag, err_details);
+            break;
+
+        case AES_XTS:
+            if (tail_size == 0)
+                return status;
+            return aes_box_decrypt_data_unit_xts(
+                box, tail, tail_size, box->xts.tweak, tail, err_details
+            );
+
+        case AES_GCM_SIV:
+            /* The tag is checked once the whole plaintext is known. */
+            return aes_box_decrypt_buffer_partial_block(box, tail, data_size, tail, err_details);
+
+        default:
+            return aes_box_decrypt_buffer_partial_block(box, tail, tail_size, tail, err_details);
+    }
+
+    if (aes_is_error(status))
+        return status;
+
+    if (!aes_box_tags_equal(tag, aes_load_block_aligned(expected_tag)))
+        return aes_error_authentication(err_details);
+
+    box->tag = tag;
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_iov_internal(
+    AES_Box* box,
+    AES_BoxIovCursor src,
+    AES_BoxIovCursor dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    size_t block_size = sizeof(AES_Block);
+    const AES_BoxIovCursor dest_begin = dest;
+    const size_t tag_size = aes_box_get_tag_size(box);
+    size_t numof_blocks = *dest_size / block_size;
+    size_t tail_size = *dest_size % block_size;
+    AES_Block expected_tag = _mm_setzero_si128();
+
+    switch (box->mode) {
+        case AES_ECB:
+        case AES_CBC:
+            --numof_blocks;
+            tail_size = block_size;
+            break;
+
+        case AES_GCM:
+            box->iv = aes_inc_block(box->gcm.j0);
+            break;
+
+        case AES_XTS:
+            if (tail_size != 0) {
+                --numof_blocks;
+                tail_size += block_size;
+            }
+
+            status = box->ops->encrypt_block(
+                &box->iv, &box->xts.tweak_keys, &box->xts.tweak, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+            break;
+
+        case AES_CCM:
+            status = aes_box_start_ccm(box, *dest_size, err_details);
+            if (aes_is_error(status))
+                return status;
+            break;
+
+        case AES_OCB:
+            aes_box_start_ocb(box);
+            break;
+
+        case AES_GCM_SIV: {
+            /* The tag is the initial counter block. */
+            AES_BoxIovCursor tag_cursor = src;
+            aes_box_iov_skip(&tag_cursor, *dest_size);
+            aes_box_iov_gather(&tag_cursor, &expected_tag, AES_BOX_TAG_SIZE);
+
+            status = aes_box_derive_keys_gcm_siv(box, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            box->gcm_siv.counter =
+                _mm_or_si128(expected_tag, aes_make_block((int)0x80000000, 0, 0, 0));
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    status = aes_box_process_iov_blocks(
+        box, &aes_box_decrypt_next_blocks, &src, &dest, numof_blocks, err_details
+    );
+    if (aes_is_error(status))
+        return status;
+
+    AES_ALIGN(unsigned char, 16) tail[32];
+    size_t output_size = 0;
+
+    aes_box_iov_gather(&src, tail, tail_size + tag_size);
+
+    status = aes_box_decrypt_iov_tail(
+        box, tail, tail_size + tag_size, *dest_size, &output_size, err_details
+    );
+    if (status == AES_AUTHENTICATION_ERROR) {
+        aes_box_iov_zero(dest_begin, numof_blocks * block_size);
+        return status;
+    }
+    if (aes_is_error(status))
+        return status;
+
+    aes_box_iov_scatter(&dest, tail, output_size);
+
+    if (box->mode == AES_GCM_SIV) {
+        AES_Block tag;
+        AES_Block hash = _mm_setzero_si128();
+        hash = aes_box_polyval_gcm_siv(box, hash, box->gcm_siv.aad, box->gcm_siv.aad_size);
+        hash = aes_box_polyval_iov_gcm_siv(box, hash, dest_begin, *dest_size);
+
+        status = aes_box_finish_gcm_siv(box, hash, *dest_size, &tag, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        if (!aes_box_tags_equal(tag, expected_tag)) {
+            aes_box_iov_zero(dest_begin, *dest_size);
+            return aes_error_authentication(err_details);
+        }
+
+        box->tag = tag;
+    }
+
+    *dest_size = numof_blocks * block_size + output_size;
+    return status;
+}
+
+static AES_StatusCode aes_box_check_iov(
+    const AES_IoVec* src,
+    size_t numof_src,
+    const AES_IoVec* dest,
+    size_t numof_dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (src == NULL && numof_src != 0)
+        return aes_error_null_argument(err_details, "src");
+    if (dest == NULL && numof_dest != 0)
+        return aes_error_null_argument(err_details, "dest");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    for (size_t i = 0; i < numof_src; ++i)
+        if (src[i].base == NULL && src[i].size != 0)
+            return aes_error_null_argument(err_details, "src");
+    for (size_t i = 0; i < numof_dest; ++i)
+        if (dest[i].base == NULL && dest[i].size != 0)
+            return aes_error_null_argument(err_details, "dest");
+
+    return AES_SUCCESS;
+}
+
+AES_StatusCode aes_box_encrypt_iov(
+    AES_Box* box,
+    const AES_IoVec* src,
+    size_t numof_src,
+    const AES_IoVec* dest,
+    size_t numof_dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+
+    status = aes_box_check_iov(src, numof_src, dest, numof_dest, dest_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    const size_t src_size = aes_box_iov_get_total_size(src, numof_src);
+    size_t padding_size = 0;
+
+    status =
+        aes_box_get_encrypted_buffer_size(box, src_size, dest_size, &padding_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (aes_box_iov_get_total_size(dest, numof_dest) < *dest_size)
+        return aes_error_buffer_too_small(err_details);
+
+    return aes_box_encrypt_iov_internal(
+        box,
+        aes_box_iov_begin(src, numof_src),
+        src_size,
+        aes_box_iov_begin(dest, numof_dest),
+        dest_size,
+        err_details
+    );
+}
+
+AES_StatusCode aes_box_decrypt_iov(
+    AES_Box* box,
+    const AES_IoVec* src,
+    size_t numof_src,
+    const AES_IoVec* dest,
+    size_t numof_dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+
+    status = aes_box_check_iov(src, numof_src, dest, numof_dest, dest_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    const size_t src_size = aes_box_iov_get_total_size(src, numof_src);
+    size_t max_padding_size = 0;
+
+    status =
+        aes_box_get_decrypted_buffer_size(box, src_size, dest_size, &max_padding_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (aes_box_iov_get_total_size(dest, numof_dest) < *dest_size)
+        return aes_error_buffer_too_small(err_details);
+
+    return aes_box_decrypt_iov_internal(
+        box,
+        aes_box_iov_begin(src, numof_src),
+        aes_box_iov_begin(dest, numof_dest),
+        dest_size,
+        err_details
+    );
+}
+
+AES_StatusCode aes_box_set_aad(
+    AES_Box* box,
+    const void* aad,
+    size_t aad_size,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (aad == NULL && aad_size != 0)
+        return aes_error_null_argument(err_details, "aad");
+    if (!aes_mode_is_authenticated(box->mode))
+        return aes_error_not_implemented(
+            err_details, "additional authenticated data requires an authenticated mode"
+        );
+    if (box->stream.started)
+        return aes_error_not_implemented(err_details, "AAD must be set before the message");
+
+    if (box->mode == AES_CCM) {
+        box->ccm.aad = aad;
+        box->ccm.aad_size = aad_size;
+        return AES_SUCCESS;
+    }
+
+    if (box->mode == AES_GCM_SIV) {
+        if ((unsigned long long)aad_size > AES_BOX_GCM_SIV_MAX_SIZE)
+            return aes_error_not_implemented(
+                err_details, "GCM-SIV additional data is limited to 64 GiB"
+            );
+
+        box->gcm_siv.aad = aad;
+        box->gcm_siv.aad_size = aad_size;
+        return AES_SUCCESS;
+    }
+
+    if (box->mode == AES_OCB) {
+        if ((unsigned long long)aad_size > AES_BOX_OCB_MAX_SIZE)
+            return aes_error_not_implemented(
+                err_details, "OCB additional data is limited to 64 GiB"
+            );
+        return aes_box_hash_ocb(box, aad, aad_size, &box->ocb.hash, err_details);
+    }
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t aad_len = aad_size / block_size;
+
+    AES_Block hash = box->gcm.ops->ghash(_mm_setzero_si128(), aad, aad_len, &box->gcm.key);
+
+    if (aad_size % block_size != 0) {
+        AES_ALIGN(unsigned char, 16) block[16];
+        memset(block, 0x00, sizeof(block));
+        memcpy(block, (const char*)aad + aad_len * block_size, aad_size % block_size);
+        hash = box->gcm.ops->ghash(hash, block, 1, &box->gcm.key);
+    }
+
+    box->gcm.hash = hash;
+    box->gcm.aad_size = aad_size;
+    return AES_SUCCESS;
+}
+
+AES_StatusCode aes_box_get_tag(const AES_Box* box, AES_Block* tag, AES_ErrorDetails* err_details) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (tag == NULL)
+        return aes_error_null_argument(err_details, "tag");
+    if (!aes_mode_is_authenticated(box->mode))
+        return aes_error_not_implemented(err_details, "tags require an authenticated mode");
+
+    *tag = box->tag;
+    return AES_SUCCESS;
+}
+
+static AES_StatusCode aes_box_check_sectors(
+    AES_Box* box,
+    const void* src,
+    size_t sector_size,
+    size_t numof_sectors,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (box->mode != AES_XTS)
+        return aes_error_not_implemented(err_details, "sectors are only supported in XTS mode");
+    if (sector_size < sizeof(AES_Block))
+        return aes_error_not_implemented(err_details, "XTS requires at least one block");
+    if (src == NULL && numof_sectors != 0)
+        return aes_error_null_argument(err_details, "src");
+    if (dest == NULL && numof_sectors != 0)
+        return aes_error_null_argument(err_details, "dest");
+    return AES_SUCCESS;
+}
+
+/* The tweaks of a whole batch of sectors are encrypted at once. */
+static AES_StatusCode aes_box_encrypt_sector_tweaks(
+    AES_Box* box,
+    unsigned long long first_sector,
+    size_t numof_sectors,
+    AES_Block* tweaks,
+    AES_ErrorDetails* err_details
+) {
+    for (size_t i = 0; i < numof_sectors; ++i) {
+        const unsigned long long sector = first_sector + i;
+        tweaks[i] = aes_make_block(0, 0, (int)(sector >> 32), (int)sector);
+    }
+
+    return box->ops->encrypt_blocks(
+        tweaks, numof_sectors, &box->xts.tweak_keys, tweaks, err_details
+    );
+}
+
+/* Sectors made of fewer whole blocks than a batch are processed several at a
+ * time, so that every call to the multi-block functions gets a whole batch.
+ * sector_len is the number of blocks in a sector. */
+static AES_StatusCode aes_box_encrypt_short_sectors_xts(
+    AES_Box* box,
+    const void* src,
+    size_t sector_len,
+    size_t numof_sectors,
+    const AES_Block* sector_tweaks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    const size_t sectors_per_batch = AES_BOX_BATCH_LEN / sector_len;
+
+    while (numof_sectors > 0) {
+        const size_t batch_sectors = numof_sectors < sectors_per_batch ? numof_sectors
+                                                                       : sectors_per_batch;
+        const size_t batch_len = batch_sectors * sector_len;
+
+        for (size_t i = 0; i < batch_sectors; ++i)
+            aes_box_fill_tweaks_xts(tweaks + i * sector_len, sector_len, sector_tweaks[i]);
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)src + i * sizeof(AES_Block)), tweaks[i]
+            );
+
+        status = box->ops->encrypt_blocks(
+            blocks, batch_len, &box->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            aes_store_block(
+                (char*)dest + i * sizeof(AES_Block), aes_xor_blocks(blocks[i], tweaks[i])
+            );
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        sector_tweaks += batch_sectors;
+        numof_sectors -= batch_sectors;
+    }
+
+    return status;
+}
+
+static AES_StatusCode aes_box_decrypt_short_sectors_xts(
+    AES_Box* box,
+    const void* src,
+    size_t sector_len,
+    size_t numof_sectors,
+    const AES_Block* sector_tweaks,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+    AES_Block blocks[AES_BOX_BATCH_LEN];
+
+    const size_t sectors_per_batch = AES_BOX_BATCH_LEN / sector_len;
+
+    while (numof_sectors > 0) {
+        const size_t batch_sectors = numof_sectors < sectors_per_batch ? numof_sectors
+                                                                       : sectors_per_batch;
+        const size_t batch_len = batch_sectors * sector_len;
+
+        for (size_t i = 0; i < batch_sectors; ++i)
+            aes_box_fill_tweaks_xts(tweaks + i * sector_len, sector_len, sector_tweaks[i]);
+
+        for (size_t i = 0; i < batch_len; ++i)
+            blocks[i] = aes_xor_blocks(
+                aes_load_block((const char*)src + i * sizeof(AES_Block)), tweaks[i]
+            );
+
+        status = box->ops->decrypt_blocks(
+            blocks, batch_len, &box->decryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t i = 0; i < batch_len; ++i)
+            aes_store_block(
+                (char*)dest + i * sizeof(AES_Block), aes_xor_blocks(blocks[i], tweaks[i])
+            );
+
+        src = (const char*)src + batch_len * sizeof(AES_Block);
+        dest = (char*)dest + batch_len * sizeof(AES_Block);
+        sector_tweaks += batch_sectors;
+        numof_sectors -= batch_sectors;
+    }
+
+    return status;
+}
+
+/* Only the sectors without a partial block can be short: a partial block
+ * steals from the block before it, so those are processed one at a time. */
+static int aes_box_is_short_sector_xts(size_t sector_size) {
+    return sector_size % sizeof(AES_Block) == 0 &&
+           sector_size < AES_BOX_BATCH_LEN * sizeof(AES_Block);
+}
+
+AES_StatusCode aes_box_encrypt_sectors(
+    AES_Box* box,
+    const void* src,
+    size_t sector_size,
+    size_t numof_sectors,
+    unsigned long long first_sector,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+
+    status = aes_box_check_sectors(box, src, sector_size, numof_sectors, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    while (numof_sectors > 0) {
+        const size_t batch_len = numof_sectors < AES_BOX_BATCH_LEN ? numof_sectors
+                                                                   : AES_BOX_BATCH_LEN;
+
+        status = aes_box_encrypt_sector_tweaks(box, first_sector, batch_len, tweaks, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        if (aes_box_is_short_sector_xts(sector_size)) {
+            status = aes_box_encrypt_short_sectors_xts(
+                box, src, sector_size / sizeof(AES_Block), batch_len, tweaks, dest, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            src = (const char*)src + batch_len * sector_size;
+            dest = (char*)dest + batch_len * sector_size;
+        } else {
+            for (size_t i = 0; i < batch_len; ++i) {
+                status = aes_box_encrypt_data_unit_xts(
+                    box, src, sector_size, tweaks[i], dest, err_details
+                );
+                if (aes_is_error(status))
+                    return status;
+
+                src = (const char*)src + sector_size;
+                dest = (char*)dest + sector_size;
+            }
+        }
+
+        first_sector += batch_len;
+        numof_sectors -= batch_len;
+    }
+
+    return status;
+}
+
+AES_StatusCode aes_box_decrypt_sectors(
+    AES_Box* box,
+    const void* src,
+    size_t sector_size,
+    size_t numof_sectors,
+    unsigned long long first_sector,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block tweaks[AES_BOX_BATCH_LEN];
+
+    status = aes_box_check_sectors(box, src, sector_size, numof_sectors, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    while (numof_sectors > 0) {
+        const size_t batch_len = numof_sectors < AES_BOX_BATCH_LEN ? numof_sectors
+                                                                   : AES_BOX_BATCH_LEN;
+
+        status = aes_box_encrypt_sector_tweaks(box, first_sector, batch_len, tweaks, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        if (aes_box_is_short_sector_xts(sector_size)) {
+            status = aes_box_decrypt_short_sectors_xts(
+                box, src, sector_size / sizeof(AES_Block), batch_len, tweaks, dest, err_details
+            );
+            if (aes_is_error(status))
+                return status;
+
+            src = (const char*)src + batch_len * sector_size;
+            dest = (char*)dest + batch_len * sector_size;
+        } else {
+            for (size_t i = 0; i < batch_len; ++i) {
+                status = aes_box_decrypt_data_unit_xts(
+                    box, src, sector_size, tweaks[i], dest, err_details
+                );
+                if (aes_is_error(status))
+                    return status;
+
+                src = (const char*)src + sector_size;
+                dest = (char*)dest + sector_size;
+            }
+        }
+
+        first_sector += batch_len;
+        numof_sectors -= batch_len;
+    }
+
+    return status;
+}
+
+AES_StatusCode aes_box_generate_keystream(
+    AES_Box* box,
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (box == NULL)
+        return aes_error_null_argument(err_details, "box");
+    if (dest == NULL && dest_size != 0)
+        return aes_error_null_argument(err_details, "dest");
+
+    switch (box->mode) {
+        case AES_OFB:
+        case AES_CTR:
+            break;
+
+        default:
+            return aes_error_not_implemented(
+                err_details, "keystream is only available in OFB and CTR modes"
+            );
+    }
+
+    if (dest_size == 0)
+        return status;
+
+    /* Encrypting zeros produces the keystream itself. */
+    memset(dest, 0x00, dest_size);
+
+    size_t block_size = sizeof(AES_Block);
+    const size_t dest_len = dest_size / block_size;
+
+    status = aes_box_encrypt_blocks_in_mode[box->mode](box, dest, dest_len, dest, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    dest = (char*)dest + dest_len * block_size;
+
+    return aes_box_encrypt_buffer_partial_block(
+        box, dest, dest_size % block_size, dest, err_details
+    );
+}
+
+AES_StatusCode aes_apply_keystream(
+    const void* src,
+    size_t src_size,
+    const void* keystream,
+    void* dest,
+    AES_ErrorDetails* err_details
+) {
+    if (src_size == 0)
+        return AES_SUCCESS;
+    if (src == NULL)
+        return aes_error_null_argument(err_details, "src");
+    if (keystream == NULL)
+        return aes_error_null_argument(err_details, "keystream");
+    if (dest == NULL)
+        return aes_error_null_argument(err_details, "dest");
+
+    const unsigned char* input = (const unsigned char*)src;
+    const unsigned char* key = (const unsigned char*)keystream;
+    unsigned char* output = (unsigned char*)dest;
+
+    size_t block_size = sizeof(AES_Block);
+
+    for (; src_size >= block_size; src_size -= block_size) {
+        aes_store_block(output, aes_xor_blocks(aes_load_block(input), aes_load_block(key)));
+        input += block_size;
+        key += block_size;
+        output += block_size;
+    }
+
+    for (size_t i = 0; i < src_size; ++i)
+        output[i] = input[i] ^ key[i];
+
+    return AES_SUCCESS;
 }
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <emmintrin.h>
+#include <stdlib.h>
+#include <wmmintrin.h>
+
+/* Each AESENC/AESDEC has a latency of several cycles, but a new one can be
+ * issued every cycle or so.
+ * Processing independent blocks in lockstep keeps the AES unit busy. */
+
+static void aes_encrypt_blocks8(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(&plaintext[0]), keys[0]);
+    AES_Block b1 = _mm_xor_si128(aes_load_block(&plaintext[1]), keys[0]);
+    AES_Block b2 = _mm_xor_si128(aes_load_block(&plaintext[2]), keys[0]);
+    AES_Block b3 = _mm_xor_si128(aes_load_block(&plaintext[3]), keys[0]);
+    AES_Block b4 = _mm_xor_si128(aes_load_block(&plaintext[4]), keys[0]);
+    AES_Block b5 = _mm_xor_si128(aes_load_block(&plaintext[5]), keys[0]);
+    AES_Block b6 = _mm_xor_si128(aes_load_block(&plaintext[6]), keys[0]);
+    AES_Block b7 = _mm_xor_si128(aes_load_block(&plaintext[7]), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        const AES_Block key = keys[i];
+        b0 = _mm_aesenc_si128(b0, key);
+        b1 = _mm_aesenc_si128(b1, key);
+        b2 = _mm_aesenc_si128(b2, key);
+        b3 = _mm_aesenc_si128(b3, key);
+        b4 = _mm_aesenc_si128(b4, key);
+        b5 = _mm_aesenc_si128(b5, key);
+        b6 = _mm_aesenc_si128(b6, key);
+        b7 = _mm_aesenc_si128(b7, key);
+    }
+
+    const AES_Block last = keys[numof_rounds];
+    aes_store_block(&ciphertext[0], _mm_aesenclast_si128(b0, last));
+    aes_store_block(&ciphertext[1], _mm_aesenclast_si128(b1, last));
+    aes_store_block(&ciphertext[2], _mm_aesenclast_si128(b2, last));
+    aes_store_block(&ciphertext[3], _mm_aesenclast_si128(b3, last));
+    aes_store_block(&ciphertext[4], _mm_aesenclast_si128(b4, last));
+    aes_store_block(&ciphertext[5], _mm_aesenclast_si128(b5, last));
+    aes_store_block(&ciphertext[6], _mm_aesenclast_si128(b6, last));
+    aes_store_block(&ciphertext[7], _mm_aesenclast_si128(b7, last));
+}
+
+static void aes_encrypt_blocks4(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(&plaintext[0]), keys[0]);
+    AES_Block b1 = _mm_xor_si128(aes_load_block(&plaintext[1]), keys[0]);
+    AES_Block b2 = _mm_xor_si128(aes_load_block(&plaintext[2]), keys[0]);
+    AES_Block b3 = _mm_xor_si128(aes_load_block(&plaintext[3]), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        const AES_Block key = keys[i];
+        b0 = _mm_aesenc_si128(b0, key);
+        b1 = _mm_aesenc_si128(b1, key);
+        b2 = _mm_aesenc_si128(b2, key);
+        b3 = _mm_aesenc_si128(b3, key);
+    }
+
+    const AES_Block last = keys[numof_rounds];
+    aes_store_block(&ciphertext[0], _mm_aesenclast_si128(b0, last));
+    aes_store_block(&ciphertext[1], _mm_aesenclast_si128(b1, last));
+    aes_store_block(&ciphertext[2], _mm_aesenclast_si128(b2, last));
+    aes_store_block(&ciphertext[3], _mm_aesenclast_si128(b3, last));
+}
+
+static void aes_encrypt_blocks2(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(&plaintext[0]), keys[0]);
+    AES_Block b1 = _mm_xor_si128(aes_load_block(&plaintext[1]), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        const AES_Block key = keys[i];
+        b0 = _mm_aesenc_si128(b0, key);
+        b1 = _mm_aesenc_si128(b1, key);
+    }
+
+    const AES_Block last = keys[numof_rounds];
+    aes_store_block(&ciphertext[0], _mm_aesenclast_si128(b0, last));
+    aes_store_block(&ciphertext[1], _mm_aesenclast_si128(b1, last));
+}
+
+static void aes_encrypt_blocks1(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(plaintext), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i)
+        b0 = _mm_aesenc_si128(b0, keys[i]);
+
+    aes_store_block(ciphertext, _mm_aesenclast_si128(b0, keys[numof_rounds]));
+}
+
+static void aes_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    for (; numof_blocks >= 8; numof_blocks -= 8, plaintext += 8, ciphertext += 8)
+        aes_encrypt_blocks8(plaintext, ciphertext, keys, numof_rounds);
+
+    if (numof_blocks >= 4) {
+        aes_encrypt_blocks4(plaintext, ciphertext, keys, numof_rounds);
+        numof_blocks -= 4;
+        plaintext += 4;
+        ciphertext += 4;
+    }
+
+    if (numof_blocks >= 2) {
+        aes_encrypt_blocks2(plaintext, ciphertext, keys, numof_rounds);
+        numof_blocks -= 2;
+        plaintext += 2;
+        ciphertext += 2;
+    }
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext)
+        aes_encrypt_blocks1(plaintext, ciphertext, keys, numof_rounds);
+}
+
+static void aes_decrypt_blocks8(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(&ciphertext[0]), keys[0]);
+    AES_Block b1 = _mm_xor_si128(aes_load_block(&ciphertext[1]), keys[0]);
+    AES_Block b2 = _mm_xor_si128(aes_load_block(&ciphertext[2]), keys[0]);
+    AES_Block b3 = _mm_xor_si128(aes_load_block(&ciphertext[3]), keys[0]);
+    AES_Block b4 = _mm_xor_si128(aes_load_block(&ciphertext[4]), keys[0]);
+    AES_Block b5 = _mm_xor_si128(aes_load_block(&ciphertext[5]), keys[0]);
+    AES_Block b6 = _mm_xor_si128(aes_load_block(&ciphertext[6]), keys[0]);
+    AES_Block b7 = _mm_xor_si128(aes_load_block(&ciphertext[7]), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        const AES_Block key = keys[i];
+        b0 = _mm_aesdec_si128(b0, key);
+        b1 = _mm_aesdec_si128(b1, key);
+        b2 = _mm_aesdec_si128(b2, key);
+        b3 = _mm_aesdec_si128(b3, key);
+        b4 = _mm_aesdec_si128(b4, key);
+        b5 = _mm_aesdec_si128(b5, key);
+        b6 = _mm_aesdec_si128(b6, key);
+        b7 = _mm_aesdec_si128(b7, key);
+    }
+
+    const AES_Block last = keys[numof_rounds];
+    aes_store_block(&plaintext[0], _mm_aesdeclast_si128(b0, last));
+    aes_store_block(&plaintext[1], _mm_aesdeclast_si128(b1, last));
+    aes_store_block(&plaintext[2], _mm_aesdeclast_si128(b2, last));
+    aes_store_block(&plaintext[3], _mm_aesdeclast_si128(b3, last));
+    aes_store_block(&plaintext[4], _mm_aesdeclast_si128(b4, last));
+    aes_store_block(&plaintext[5], _mm_aesdeclast_si128(b5, last));
+    aes_store_block(&plaintext[6], _mm_aesdeclast_si128(b6, last));
+    aes_store_block(&plaintext[7], _mm_aesdeclast_si128(b7, last));
+}
+
+static void aes_decrypt_blocks4(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(&ciphertext[0]), keys[0]);
+    AES_Block b1 = _mm_xor_si128(aes_load_block(&ciphertext[1]), keys[0]);
+    AES_Block b2 = _mm_xor_si128(aes_load_block(&ciphertext[2]), keys[0]);
+    AES_Block b3 = _mm_xor_si128(aes_load_block(&ciphertext[3]), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        const AES_Block key = keys[i];
+        b0 = _mm_aesdec_si128(b0, key);
+        b1 = _mm_aesdec_si128(b1, key);
+        b2 = _mm_aesdec_si128(b2, key);
+        b3 = _mm_aesdec_si128(b3, key);
+    }
+
+    const AES_Block last = keys[numof_rounds];
+    aes_store_block(&plaintext[0], _mm_aesdeclast_si128(b0, last));
+    aes_store_block(&plaintext[1], _mm_aesdeclast_si128(b1, last));
+    aes_store_block(&plaintext[2], _mm_aesdeclast_si128(b2, last));
+    aes_store_block(&plaintext[3], _mm_aesdeclast_si128(b3, last));
+}
+
+static void aes_decrypt_blocks1(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = _mm_xor_si128(aes_load_block(ciphertext), keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i)
+        b0 = _mm_aesdec_si128(b0, keys[i]);
+
+    aes_store_block(plaintext, _mm_aesdeclast_si128(b0, keys[numof_rounds]));
+}
+
+static void aes_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    for (; numof_blocks >= 8; numof_blocks -= 8, ciphertext += 8, plaintext += 8)
+        aes_decrypt_blocks8(ciphertext, plaintext, keys, numof_rounds);
+
+    if (numof_blocks >= 4) {
+        aes_decrypt_blocks4(ciphertext, plaintext, keys, numof_rounds);
+        numof_blocks -= 4;
+        ciphertext += 4;
+        plaintext += 4;
+    }
+
+    for (; numof_blocks > 0; --numof_blocks, ++ciphertext, ++plaintext)
+        aes_decrypt_blocks1(ciphertext, plaintext, keys, numof_rounds);
+}
+
+/* In the chained modes, every block depends on the previous one.
+ * The round keys are copied to a local array first: the output could alias
+ * them otherwise, which would make the compiler reload them for every
+ * block. */
+
+static void aes_load_round_keys(AES_Block* dest, const AES_Block* keys, int numof_rounds) {
+    for (int i = 0; i <= numof_rounds; ++i)
+        dest[i] = keys[i];
+}
+
+static AES_Block aes_encrypt_block_chained(
+    AES_Block block,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    block = _mm_xor_si128(block, keys[0]);
+
+    for (int i = 1; i < numof_rounds; ++i)
+        block = _mm_aesenc_si128(block, keys[i]);
+
+    return _mm_aesenclast_si128(block, keys[numof_rounds]);
+}
+
+static void aes_encrypt_cbc(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block round_keys[15];
+    AES_Block chain = *iv;
+
+    aes_load_round_keys(round_keys, keys, numof_rounds);
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        const AES_Block block = _mm_xor_si128(aes_load_block(plaintext), chain);
+        chain = aes_encrypt_block_chained(block, round_keys, numof_rounds);
+        aes_store_block(ciphertext, chain);
+    }
+
+    *iv = chain;
+}
+
+static void aes_encrypt_cfb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block round_keys[15];
+    AES_Block chain = *iv;
+
+    aes_load_round_keys(round_keys, keys, numof_rounds);
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        const AES_Block keystream = aes_encrypt_block_chained(chain, round_keys, numof_rounds);
+        chain = _mm_xor_si128(keystream, aes_load_block(plaintext));
+        aes_store_block(ciphertext, chain);
+    }
+
+    *iv = chain;
+}
+
+static void aes_encrypt_ofb(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block round_keys[15];
+    AES_Block chain = *iv;
+
+    aes_load_round_keys(round_keys, keys, numof_rounds);
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        chain = aes_encrypt_block_chained(chain, round_keys, numof_rounds);
+        aes_store_block(ciphertext, _mm_xor_si128(chain, aes_load_block(plaintext)));
+    }
+
+    *iv = chain;
+}
+
+void AES_ASM_ATTR aes128_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_encrypt_blocks_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 14);
+}
+
+void AES_ASM_ATTR aes128_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_encrypt_pair_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 14);
+}
+
+void AES_ASM_ATTR aes128_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+) {
+    aes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+) {
+    aes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_decrypt_blocks_internal(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+) {
+    aes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 14);
+}
+
+void AES_ASM_ATTR aes128_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_encrypt_cbc_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
+
+void AES_ASM_ATTR aes128_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_encrypt_cfb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
+
+void AES_ASM_ATTR aes128_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void AES_ASM_ATTR aes192_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void AES_ASM_ATTR aes256_encrypt_ofb_internal(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+/* The blocks are byte-reversed, so that PCLMULQDQ can multiply them directly.
+ * The product is then bit-reflected (shifted left by one bit), see Intel's
+ * "Intel Carry-Less Multiplication Instruction and its Usage for Computing the
+ * GCM Mode", algorithms 2 & 5. */
+
+static inline void aes_ghash_mul(
+    AES_Block a,
+    AES_Block b,
+    AES_Block* lo,
+    AES_Block* mid,
+    AES_Block* hi
+) {
+    *lo = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x01));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x10));
+}
+
+/* The reduction is linear, so a sum of products needs just one. */
+static inline AES_Block aes_ghash_reduce(AES_Block lo, AES_Block mid, AES_Block hi) {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    AES_Block carry_lo = _mm_srli_epi32(lo, 31);
+    AES_Block carry_hi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    hi = _mm_or_si128(hi, _mm_srli_si128(carry_lo, 12));
+    hi = _mm_or_si128(hi, _mm_slli_si128(carry_hi, 4));
+    lo = _mm_or_si128(lo, _mm_slli_si128(carry_lo, 4));
+
+    AES_Block a = _mm_slli_epi32(lo, 31);
+    a = _mm_xor_si128(a, _mm_slli_epi32(lo, 30));
+    a = _mm_xor_si128(a, _mm_slli_epi32(lo, 25));
+    const AES_Block b = _mm_srli_si128(a, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(a, 12));
+
+    AES_Block c = _mm_srli_epi32(lo, 1);
+    c = _mm_xor_si128(c, _mm_srli_epi32(lo, 2));
+    c = _mm_xor_si128(c, _mm_srli_epi32(lo, 7));
+    c = _mm_xor_si128(c, b);
+    lo = _mm_xor_si128(lo, c);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+static inline AES_Block aes_ghash_mul_reduce(AES_Block a, AES_Block b) {
+    AES_Block lo = _mm_setzero_si128();
+    AES_Block mid = _mm_setzero_si128();
+    AES_Block hi = _mm_setzero_si128();
+    aes_ghash_mul(a, b, &lo, &mid, &hi);
+    return aes_ghash_reduce(lo, mid, hi);
+}
+
+static inline AES_Block aes_ghash_load(const void* src, size_t i) {
+    return aes_reverse_byte_order(aes_load_block((const char*)src + i * sizeof(AES_Block)));
+}
+
+/* key->powers[i] is H^(i+1). */
+void aes_ghash_init_key_clmul(AES_GhashKey* key, AES_Block h) {
+    h = aes_reverse_byte_order(h);
+    key->powers[0] = h;
+    for (int i = 1; i < AES_GHASH_NUMOF_POWERS; ++i)
+        key->powers[i] = aes_ghash_mul_reduce(key->powers[i - 1], h);
+}
+
+AES_Block aes_ghash_clmul(
+    AES_Block hash,
+    const void* src,
+    size_t numof_blocks,
+    const AES_GhashKey* key
+) {
+    hash = aes_reverse_byte_order(hash);
+
+    /* Y' = (Y ^ X[0]) * H^n ^ X[1] * H^(n-1) ^ ... ^ X[n-1] * H */
+    for (; numof_blocks >= AES_GHASH_NUMOF_POWERS; numof_blocks -= AES_GHASH_NUMOF_POWERS) {
+        AES_Block lo = _mm_setzero_si128();
+        AES_Block mid = _mm_setzero_si128();
+        AES_Block hi = _mm_setzero_si128();
+
+        aes_ghash_mul(
+            _mm_xor_si128(hash, aes_ghash_load(src, 0)),
+            key->powers[AES_GHASH_NUMOF_POWERS - 1],
+            &lo,
+            &mid,
+            &hi
+        );
+        for (int i = 1; i < AES_GHASH_NUMOF_POWERS; ++i)
+            aes_ghash_mul(
+                aes_ghash_load(src, i), key->powers[AES_GHASH_NUMOF_POWERS - 1 - i], &lo, &mid, &hi
+            );
+
+        hash = aes_ghash_reduce(lo, mid, hi);
+        src = (const char*)src + AES_GHASH_NUMOF_POWERS * sizeof(AES_Block);
+    }
+
+    for (size_t i = 0; i < numof_blocks; ++i)
+        hash = aes_ghash_mul_reduce(_mm_xor_si128(hash, aes_ghash_load(src, i)), key->powers[0]);
+
+    return aes_reverse_byte_order(hash);
+}
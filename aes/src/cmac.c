@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <emmintrin.h>
+#include <string.h>
+
+AES_StatusCode aes_cmac_init(
+    AES_Cmac* cmac,
+    AES_Algorithm algorithm,
+    const AES_Key* key,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_DecryptionRoundKeys decryption_keys;
+
+    if (cmac == NULL)
+        return aes_error_null_argument(err_details, "cmac");
+    if (key == NULL)
+        return aes_error_null_argument(err_details, "key");
+
+    cmac->algorithm = algorithm;
+    cmac->ops = aes_get_ops(algorithm);
+
+    status = cmac->ops->expand_key(key, &cmac->encryption_keys, &decryption_keys, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    /* K1 = double(E(0)), K2 = double(K1). */
+    const AES_Block zero = _mm_setzero_si128();
+    AES_Block l;
+
+    status = cmac->ops->encrypt_block(&zero, &cmac->encryption_keys, &l, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    cmac->k1 = aes_double_block(l);
+    cmac->k2 = aes_double_block(cmac->k1);
+    return status;
+}
+
+/* The number of blocks in a message, the empty message being a single
+ * (padded) block. */
+static size_t aes_cmac_get_numof_blocks(size_t src_size) {
+    if (src_size == 0)
+        return 1;
+    return (src_size + sizeof(AES_Block) - 1) / sizeof(AES_Block);
+}
+
+/* The last block is XORed with K1 if it's complete, otherwise it's padded with
+ * 10...0 & XORed with K2. */
+static AES_Block aes_cmac_get_last_block(const AES_Cmac* cmac, const void* src, size_t src_size) {
+    const size_t block_size = sizeof(AES_Block);
+    const size_t offset = (aes_cmac_get_numof_blocks(src_size) - 1) * block_size;
+    const size_t last_size = src_size - offset;
+
+    if (last_size == block_size)
+        return aes_xor_blocks(aes_load_block((const char*)src + offset), cmac->k1);
+
+    AES_ALIGN(unsigned char, 16) block[16];
+    memset(block, 0x00, sizeof(block));
+    if (last_size != 0)
+        memcpy(block, (const char*)src + offset, last_size);
+    block[last_size] = 0x80;
+
+    return aes_xor_blocks(aes_load_block_aligned(block), cmac->k2);
+}
+
+/* Every message but the longest one drops out of the batch once all of its
+ * blocks except the last one are processed.
+ * The last blocks of all the messages are then encrypted together. */
+static AES_StatusCode aes_cmac_compute_group(
+    const AES_Cmac* cmac,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_messages,
+    AES_Block* macs,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block blocks[AES_CMAC_BATCH_LEN];
+    size_t indices[AES_CMAC_BATCH_LEN];
+    size_t lens[AES_CMAC_BATCH_LEN];
+
+    const size_t block_size = sizeof(AES_Block);
+    size_t max_len = 0;
+
+    for (size_t i = 0; i < numof_messages; ++i) {
+        macs[i] = _mm_setzero_si128();
+        lens[i] = aes_cmac_get_numof_blocks(src_sizes[i]) - 1;
+        if (lens[i] > max_len)
+            max_len = lens[i];
+    }
+
+    for (size_t j = 0; j < max_len; ++j) {
+        size_t numof_blocks = 0;
+
+        for (size_t i = 0; i < numof_messages; ++i) {
+            if (j >= lens[i])
+                continue;
+            const AES_Block input = aes_load_block((const char*)srcs[i] + j * block_size);
+            indices[numof_blocks] = i;
+            blocks[numof_blocks] = aes_xor_blocks(macs[i], input);
+            ++numof_blocks;
+        }
+
+        status = cmac->ops->encrypt_blocks(
+            blocks, numof_blocks, &cmac->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t k = 0; k < numof_blocks; ++k)
+            macs[indices[k]] = blocks[k];
+    }
+
+    for (size_t i = 0; i < numof_messages; ++i)
+        blocks[i] = aes_xor_blocks(macs[i], aes_cmac_get_last_block(cmac, srcs[i], src_sizes[i]));
+
+    return cmac->ops->encrypt_blocks(
+        blocks, numof_messages, &cmac->encryption_keys, macs, err_details
+    );
+}
+
+AES_StatusCode aes_cmac_compute(
+    const AES_Cmac* cmac,
+    const void* src,
+    size_t src_size,
+    AES_Block* mac,
+    AES_ErrorDetails* err_details
+) {
+    return aes_cmac_compute_batch(cmac, &src, &src_size, 1, mac, err_details);
+}
+
+AES_StatusCode aes_cmac_compute_batch(
+    const AES_Cmac* cmac,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_messages,
+    AES_Block* macs,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (cmac == NULL)
+        return aes_error_null_argument(err_details, "cmac");
+    if (numof_messages == 0)
+        return status;
+    if (srcs == NULL)
+        return aes_error_null_argument(err_details, "srcs");
+    if (src_sizes == NULL)
+        return aes_error_null_argument(err_details, "src_sizes");
+    if (macs == NULL)
+        return aes_error_null_argument(err_details, "macs");
+
+    for (size_t i = 0; i < numof_messages; ++i)
+        if (srcs[i] == NULL && src_sizes[i] != 0)
+            return aes_error_null_argument(err_details, "srcs");
+
+    while (numof_messages > 0) {
+        const size_t batch_len = numof_messages < AES_CMAC_BATCH_LEN ? numof_messages
+                                                                    : AES_CMAC_BATCH_LEN;
+
+        status = aes_cmac_compute_group(cmac, srcs, src_sizes, batch_len, macs, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        srcs += batch_len;
+        src_sizes += batch_len;
+        macs += batch_len;
+        numof_messages -= batch_len;
+    }
+
+    return status;
+}
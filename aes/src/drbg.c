@@ -0,0 +1,672 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#ifdef WIN32
+/* For rand_s. */
+#define _CRT_RAND_S
+#endif
+
+#include <aes/all.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#define AES_CTR_DRBG_MAX_SEED_SIZE 48
+
+/* The number of counter blocks encrypted at once. */
+#define AES_CTR_DRBG_BATCH_LEN 32
+
+/* The thread-local instances are reseeded after this many requests (of up to
+ * AES_CTR_DRBG_MAX_REQUEST_SIZE bytes each). */
+#define AES_CTR_DRBG_THREAD_LOCAL_RESEED_INTERVAL (1 << 16)
+
+static size_t aes_ctr_drbg_get_key_size(AES_Algorithm algorithm) {
+    switch (algorithm) {
+        case AES_AES128:
+            return 16;
+        case AES_AES192:
+            return 24;
+        default:
+            return 32;
+    }
+}
+
+static size_t aes_ctr_drbg_get_seed_size(AES_Algorithm algorithm) {
+    return aes_ctr_drbg_get_key_size(algorithm) + sizeof(AES_Block);
+}
+
+static AES_Key aes_ctr_drbg_load_key(AES_Algorithm algorithm, const unsigned char* src) {
+    AES_ALIGN(unsigned char, 16) bytes[32];
+    AES_Key key;
+
+    memset(bytes, 0x00, sizeof(bytes));
+    memcpy(bytes, src, aes_ctr_drbg_get_key_size(algorithm));
+
+    switch (algorithm) {
+        case AES_AES128:
+            key.aes128_key.key = aes_load_block_aligned(bytes);
+            break;
+        case AES_AES192:
+            key.aes192_key.lo = aes_load_block_aligned(bytes);
+            key.aes192_key.hi = aes_load_block_aligned(bytes + 16);
+            break;
+        default:
+            key.aes256_key.lo = aes_load_block_aligned(bytes);
+            key.aes256_key.hi = aes_load_block_aligned(bytes + 16);
+            break;
+    }
+
+    return key;
+}
+
+/* V is a 128-bit big-endian number, it's split into two native halves while
+ * the counter blocks are generated. */
+
+static void aes_ctr_drbg_split_v(AES_Block v, unsigned long long* hi, unsigned long long* lo) {
+    AES_ALIGN(unsigned char, 16) bytes[16];
+    aes_store_block_aligned(bytes, aes_reverse_byte_order(v));
+    memcpy(lo, bytes, 8);
+    memcpy(hi, bytes + 8, 8);
+}
+
+static AES_Block aes_ctr_drbg_join_v(unsigned long long hi, unsigned long long lo) {
+    return aes_reverse_byte_order(
+        aes_make_block((int)(hi >> 32), (int)hi, (int)(lo >> 32), (int)lo)
+    );
+}
+
+/* Encrypts V + 1, V + 2, etc. until there's dest_size bytes of output,
+ * incrementing V. */
+static AES_StatusCode aes_ctr_drbg_generate_blocks(
+    AES_CtrDrbg* drbg,
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block blocks[AES_CTR_DRBG_BATCH_LEN];
+
+    unsigned long long hi, lo;
+    aes_ctr_drbg_split_v(drbg->v, &hi, &lo);
+
+    while (dest_size > 0) {
+        const size_t numof_blocks = (dest_size + sizeof(AES_Block) - 1) / sizeof(AES_Block);
+        const size_t batch_len = numof_blocks < AES_CTR_DRBG_BATCH_LEN ? numof_blocks
+                                                                      : AES_CTR_DRBG_BATCH_LEN;
+
+        for (size_t i = 0; i < batch_len; ++i) {
+            if (++lo == 0)
+                ++hi;
+            blocks[i] = aes_ctr_drbg_join_v(hi, lo);
+        }
+
+        status = drbg->ops->encrypt_blocks(
+            blocks, batch_len, &drbg->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        const size_t batch_size =
+            dest_size < batch_len * sizeof(AES_Block) ? dest_size : batch_len * sizeof(AES_Block);
+        memcpy(dest, blocks, batch_size);
+
+        dest = (char*)dest + batch_size;
+        dest_size -= batch_size;
+    }
+
+    drbg->v = aes_ctr_drbg_join_v(hi, lo);
+    return status;
+}
+
+/* CTR_DRBG_Update: the next seedlen bytes of output, XORed with the provided
+ * data (zeros if it's NULL), become the new key & V. */
+static AES_StatusCode aes_ctr_drbg_update(
+    AES_CtrDrbg* drbg,
+    const unsigned char* provided,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_ALIGN(unsigned char, 16) temp[AES_CTR_DRBG_MAX_SEED_SIZE];
+    AES_DecryptionRoundKeys decryption_keys;
+
+    const size_t key_size = aes_ctr_drbg_get_key_size(drbg->algorithm);
+    const size_t seed_size = aes_ctr_drbg_get_seed_size(drbg->algorithm);
+
+    status = aes_ctr_drbg_generate_blocks(drbg, temp, seed_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (provided != NULL)
+        for (size_t i = 0; i < seed_size; ++i)
+            temp[i] ^= provided[i];
+
+    const AES_Key key = aes_ctr_drbg_load_key(drbg->algorithm, temp);
+    drbg->v = aes_load_block(temp + key_size);
+
+    return drbg->ops->expand_key(&key, &drbg->encryption_keys, &decryption_keys, err_details);
+}
+
+typedef struct {
+    const void* data;
+    size_t size;
+} AES_CtrDrbgInput;
+
+static void aes_ctr_drbg_store_be32(unsigned char* dest, size_t x) {
+    for (int i = 3; i >= 0; --i, x >>= 8)
+        dest[i] = (unsigned char)x;
+}
+
+static AES_StatusCode aes_ctr_drbg_bcc(
+    const AES_CtrDrbg* drbg,
+    AES_Block* chains,
+    size_t numof_chains,
+    const unsigned char* block,
+    AES_ErrorDetails* err_details
+) {
+    const AES_Block input = aes_load_block_aligned(block);
+
+    for (size_t i = 0; i < numof_chains; ++i)
+        chains[i] = aes_xor_blocks(chains[i], input);
+
+    return drbg->ops->encrypt_blocks(chains, numof_chains, &drbg->df_keys, chains, err_details);
+}
+
+/* Block_Cipher_df, the input being the concatenation of the inputs.
+ * The BCC chains for IV = 0, 1, etc. are computed together, the string
+ * S = L || N || input || 0x80 || 0...0 being read a block at a time.
+ * The seed buffer must be AES_CTR_DRBG_MAX_SEED_SIZE bytes long. */
+static AES_StatusCode aes_ctr_drbg_df(
+    const AES_CtrDrbg* drbg,
+    const AES_CtrDrbgInput* inputs,
+    size_t numof_inputs,
+    unsigned char* seed,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block chains[AES_CTR_DRBG_MAX_SEED_SIZE / sizeof(AES_Block)];
+    AES_ALIGN(unsigned char, 16) block[16];
+
+    const size_t key_size = aes_ctr_drbg_get_key_size(drbg->algorithm);
+    const size_t seed_size = aes_ctr_drbg_get_seed_size(drbg->algorithm);
+    const size_t numof_chains = (seed_size + sizeof(AES_Block) - 1) / sizeof(AES_Block);
+
+    unsigned long long input_size = 0;
+    for (size_t i = 0; i < numof_inputs; ++i)
+        input_size += inputs[i].size;
+    if (input_size > 0xffffffffull)
+        return aes_error_not_implemented(err_details, "CTR_DRBG inputs are limited to 4 GiB");
+
+    for (size_t i = 0; i < numof_chains; ++i)
+        chains[i] = aes_reverse_byte_order(aes_make_block((int)i, 0, 0, 0));
+
+    status = drbg->ops->encrypt_blocks(chains, numof_chains, &drbg->df_keys, chains, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    aes_ctr_drbg_store_be32(block, (size_t)input_size);
+    aes_ctr_drbg_store_be32(block + 4, seed_size);
+    size_t block_size = 8;
+
+    for (size_t i = 0; i < numof_inputs; ++i) {
+        const unsigned char* data = (const unsigned char*)inputs[i].data;
+        size_t data_size = inputs[i].size;
+
+        while (data_size > 0) {
+            const size_t chunk_size =
+                data_size < sizeof(block) - block_size ? data_size : sizeof(block) - block_size;
+            memcpy(block + block_size, data, chunk_size);
+            block_size += chunk_size;
+            data += chunk_size;
+            data_size -= chunk_size;
+
+            if (block_size < sizeof(block))
+                continue;
+
+            status = aes_ctr_drbg_bcc(drbg, chains, numof_chains, block, err_details);
+            if (aes_is_error(status))
+                return status;
+            block_size = 0;
+        }
+    }
+
+    block[block_size++] = 0x80;
+    memset(block + block_size, 0x00, sizeof(block) - block_size);
+
+    status = aes_ctr_drbg_bcc(drbg, chains, numof_chains, block, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    /* K = the first keylen bytes of the chains, X = the next block. */
+    AES_ALIGN(unsigned char, 16) temp[AES_CTR_DRBG_MAX_SEED_SIZE];
+    AES_EncryptionRoundKeys encryption_keys;
+    AES_DecryptionRoundKeys decryption_keys;
+
+    for (size_t i = 0; i < numof_chains; ++i)
+        aes_store_block_aligned(temp + i * sizeof(AES_Block), chains[i]);
+
+    const AES_Key key = aes_ctr_drbg_load_key(drbg->algorithm, temp);
+    AES_Block x = aes_load_block(temp + key_size);
+
+    status = drbg->ops->expand_key(&key, &encryption_keys, &decryption_keys, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    for (size_t i = 0; i < numof_chains; ++i) {
+        status = drbg->ops->encrypt_block(&x, &encryption_keys, &x, err_details);
+        if (aes_is_error(status))
+            return status;
+        aes_store_block(seed + i * sizeof(AES_Block), x);
+    }
+
+    return status;
+}
+
+/* Without the derivation function, the seed material is the entropy input
+ * XORed with the (zero-padded) personalization string or additional input. */
+static void aes_ctr_drbg_xor_seed(
+    const AES_CtrDrbg* drbg,
+    const void* entropy,
+    const void* data,
+    size_t data_size,
+    unsigned char* seed
+) {
+    const size_t seed_size = aes_ctr_drbg_get_seed_size(drbg->algorithm);
+
+    memset(seed, 0x00, seed_size);
+    if (data_size != 0)
+        memcpy(seed, data, data_size);
+    if (entropy != NULL)
+        for (size_t i = 0; i < seed_size; ++i)
+            seed[i] ^= ((const unsigned char*)entropy)[i];
+}
+
+static AES_StatusCode aes_ctr_drbg_check_inputs(
+    const AES_CtrDrbg* drbg,
+    size_t entropy_size,
+    size_t data_size,
+    AES_ErrorDetails* err_details
+) {
+    const size_t key_size = aes_ctr_drbg_get_key_size(drbg->algorithm);
+    const size_t seed_size = aes_ctr_drbg_get_seed_size(drbg->algorithm);
+
+    if (drbg->use_df) {
+        if (entropy_size < key_size)
+            return aes_error_not_implemented(
+                err_details, "CTR_DRBG entropy input must be at least as long as the key"
+            );
+        return AES_SUCCESS;
+    }
+
+    if (entropy_size != seed_size)
+        return aes_error_not_implemented(
+            err_details, "CTR_DRBG entropy input must be seedlen bytes long without the df"
+        );
+    if (data_size > seed_size)
+        return aes_error_not_implemented(
+            err_details, "CTR_DRBG inputs must be at most seedlen bytes long without the df"
+        );
+    return AES_SUCCESS;
+}
+
+AES_StatusCode aes_ctr_drbg_init(
+    AES_CtrDrbg* drbg,
+    AES_Algorithm algorithm,
+    int use_df,
+    const void* entropy,
+    size_t entropy_size,
+    const void* nonce,
+    size_t nonce_size,
+    const void* personalization,
+    size_t personalization_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_ALIGN(unsigned char, 16) seed[AES_CTR_DRBG_MAX_SEED_SIZE];
+    AES_DecryptionRoundKeys decryption_keys;
+
+    if (drbg == NULL)
+        return aes_error_null_argument(err_details, "drbg");
+    if (entropy == NULL)
+        return aes_error_null_argument(err_details, "entropy");
+    if (nonce == NULL && nonce_size != 0)
+        return aes_error_null_argument(err_details, "nonce");
+    if (personalization == NULL && personalization_size != 0)
+        return aes_error_null_argument(err_details, "personalization");
+
+    drbg->algorithm = algorithm;
+    drbg->ops = aes_get_ops(algorithm);
+    drbg->use_df = use_df != 0;
+
+    status = aes_ctr_drbg_check_inputs(drbg, entropy_size, personalization_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    /* The derivation function's key is 00 01 02 ... */
+    if (drbg->use_df) {
+        unsigned char df_key[32];
+        for (size_t i = 0; i < sizeof(df_key); ++i)
+            df_key[i] = (unsigned char)i;
+
+        const AES_Key key = aes_ctr_drbg_load_key(algorithm, df_key);
+        status = drbg->ops->expand_key(&key, &drbg->df_keys, &decryption_keys, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        const AES_CtrDrbgInput inputs[] = {
+            {entropy, entropy_size},
+            {nonce, nonce_size},
+            {personalization, personalization_size},
+        };
+
+        status = aes_ctr_drbg_df(drbg, inputs, 3, seed, err_details);
+        if (aes_is_error(status))
+            return status;
+    } else {
+        aes_ctr_drbg_xor_seed(drbg, entropy, personalization, personalization_size, seed);
+    }
+
+    /* Key = 0, V = 0. */
+    const unsigned char zero[32] = {0};
+    const AES_Key key = aes_ctr_drbg_load_key(algorithm, zero);
+
+    status = drbg->ops->expand_key(&key, &drbg->encryption_keys, &decryption_keys, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    drbg->v = _mm_setzero_si128();
+
+    status = aes_ctr_drbg_update(drbg, seed, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    drbg->reseed_counter = 1;
+    drbg->reseed_interval = AES_CTR_DRBG_MAX_RESEED_INTERVAL;
+    return status;
+}
+
+AES_StatusCode aes_ctr_drbg_reseed(
+    AES_CtrDrbg* drbg,
+    const void* entropy,
+    size_t entropy_size,
+    const void* additional,
+    size_t additional_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_ALIGN(unsigned char, 16) seed[AES_CTR_DRBG_MAX_SEED_SIZE];
+
+    if (drbg == NULL)
+        return aes_error_null_argument(err_details, "drbg");
+    if (entropy == NULL)
+        return aes_error_null_argument(err_details, "entropy");
+    if (additional == NULL && additional_size != 0)
+        return aes_error_null_argument(err_details, "additional");
+
+    status = aes_ctr_drbg_check_inputs(drbg, entropy_size, additional_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (drbg->use_df) {
+        const AES_CtrDrbgInput inputs[] = {
+            {entropy, entropy_size},
+            {additional, additional_size},
+        };
+
+        status = aes_ctr_drbg_df(drbg, inputs, 2, seed, err_details);
+        if (aes_is_error(status))
+            return status;
+    } else {
+        aes_ctr_drbg_xor_seed(drbg, entropy, additional, additional_size, seed);
+    }
+
+    status = aes_ctr_drbg_update(drbg, seed, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    drbg->reseed_counter = 1;
+    return status;
+}
+
+static AES_StatusCode aes_ctr_drbg_generate_request(
+    AES_CtrDrbg* drbg,
+    void* dest,
+    size_t dest_size,
+    const void* additional,
+    size_t additional_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_ALIGN(unsigned char, 16) seed[AES_CTR_DRBG_MAX_SEED_SIZE];
+    const unsigned char* provided = NULL;
+
+    if (drbg->reseed_counter > drbg->reseed_interval)
+        return aes_error_reseed_required(err_details);
+
+    if (additional_size != 0) {
+        if (drbg->use_df) {
+            const AES_CtrDrbgInput inputs[] = {
+                {additional, additional_size},
+            };
+
+            status = aes_ctr_drbg_df(drbg, inputs, 1, seed, err_details);
+            if (aes_is_error(status))
+                return status;
+        } else {
+            aes_ctr_drbg_xor_seed(drbg, NULL, additional, additional_size, seed);
+        }
+
+        status = aes_ctr_drbg_update(drbg, seed, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        provided = seed;
+    }
+
+    status = aes_ctr_drbg_generate_blocks(drbg, dest, dest_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    status = aes_ctr_drbg_update(drbg, provided, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    ++drbg->reseed_counter;
+    return status;
+}
+
+AES_StatusCode aes_ctr_drbg_generate(
+    AES_CtrDrbg* drbg,
+    void* dest,
+    size_t dest_size,
+    const void* additional,
+    size_t additional_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (drbg == NULL)
+        return aes_error_null_argument(err_details, "drbg");
+    if (dest == NULL && dest_size != 0)
+        return aes_error_null_argument(err_details, "dest");
+    if (additional == NULL && additional_size != 0)
+        return aes_error_null_argument(err_details, "additional");
+
+    if (!drbg->use_df && additional_size > aes_ctr_drbg_get_seed_size(drbg->algorithm))
+        return aes_error_not_implemented(
+            err_details, "CTR_DRBG inputs must be at most seedlen bytes long without the df"
+        );
+
+    do {
+        const size_t request_size = dest_size < AES_CTR_DRBG_MAX_REQUEST_SIZE
+                                        ? dest_size
+                                        : AES_CTR_DRBG_MAX_REQUEST_SIZE;
+
+        status = aes_ctr_drbg_generate_request(
+            drbg, dest, request_size, additional, additional_size, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        additional = NULL;
+        additional_size = 0;
+
+        dest = (char*)dest + request_size;
+        dest_size -= request_size;
+    } while (dest_size > 0);
+
+    return status;
+}
+
+#ifdef WIN32
+static AES_StatusCode aes_ctr_drbg_get_os_entropy(
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+) {
+    while (dest_size > 0) {
+        unsigned int x;
+        if (rand_s(&x) != 0)
+            return aes_error_entropy_source(err_details);
+
+        const size_t chunk_size = dest_size < sizeof(x) ? dest_size : sizeof(x);
+        memcpy(dest, &x, chunk_size);
+
+        dest = (char*)dest + chunk_size;
+        dest_size -= chunk_size;
+    }
+
+    return AES_SUCCESS;
+}
+
+/* There's no fork() on Windows. */
+static unsigned long aes_ctr_drbg_get_pid(void) {
+    return 0;
+}
+#else
+static AES_StatusCode aes_ctr_drbg_get_os_entropy(
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+) {
+    FILE* file = fopen("/dev/urandom", "rb");
+    if (file == NULL)
+        return aes_error_entropy_source(err_details);
+
+    const size_t read_size = fread(dest, 1, dest_size, file);
+    fclose(file);
+
+    if (read_size != dest_size)
+        return aes_error_entropy_source(err_details);
+    return AES_SUCCESS;
+}
+
+static unsigned long aes_ctr_drbg_get_pid(void) {
+    return (unsigned long)getpid();
+}
+#endif
+
+/* Clears the entropy input, so that it doesn't stay on the stack. The writes
+ * are done through a volatile pointer, so that they're not optimized out. */
+static void aes_ctr_drbg_wipe(void* ptr, size_t size) {
+    volatile unsigned char* bytes = (volatile unsigned char*)ptr;
+
+    for (size_t i = 0; i < size; ++i)
+        bytes[i] = 0;
+}
+
+static AES_THREAD_LOCAL AES_CtrDrbg aes_ctr_drbg_thread_local;
+static AES_THREAD_LOCAL int aes_ctr_drbg_thread_local_ready = 0;
+static AES_THREAD_LOCAL unsigned long aes_ctr_drbg_thread_local_pid = 0;
+
+static AES_StatusCode aes_ctr_drbg_generate_thread_local_internal(
+    void* dest,
+    size_t dest_size,
+    unsigned char entropy[48],
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_CtrDrbg* drbg = &aes_ctr_drbg_thread_local;
+    const unsigned long pid = aes_ctr_drbg_get_pid();
+
+    if (!aes_ctr_drbg_thread_local_ready) {
+        status = aes_ctr_drbg_get_os_entropy(entropy, 48, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        status = aes_ctr_drbg_init(
+            drbg, AES_AES256, 1, entropy, 32, entropy + 32, 16, NULL, 0, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        drbg->reseed_interval = AES_CTR_DRBG_THREAD_LOCAL_RESEED_INTERVAL;
+        aes_ctr_drbg_thread_local_pid = pid;
+        aes_ctr_drbg_thread_local_ready = 1;
+    }
+
+    /* A forked child starts with a copy of the parent's instance, so it's
+     * reseeded before it can repeat the parent's output. */
+    if (aes_ctr_drbg_thread_local_pid != pid) {
+        status = aes_ctr_drbg_get_os_entropy(entropy, 32, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        status = aes_ctr_drbg_reseed(drbg, entropy, 32, NULL, 0, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        aes_ctr_drbg_thread_local_pid = pid;
+    }
+
+    do {
+        const size_t request_size = dest_size < AES_CTR_DRBG_MAX_REQUEST_SIZE
+                                        ? dest_size
+                                        : AES_CTR_DRBG_MAX_REQUEST_SIZE;
+
+        if (drbg->reseed_counter > drbg->reseed_interval) {
+            status = aes_ctr_drbg_get_os_entropy(entropy, 32, err_details);
+            if (aes_is_error(status))
+                return status;
+
+            status = aes_ctr_drbg_reseed(drbg, entropy, 32, NULL, 0, err_details);
+            if (aes_is_error(status))
+                return status;
+        }
+
+        status = aes_ctr_drbg_generate_request(drbg, dest, request_size, NULL, 0, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        dest = (char*)dest + request_size;
+        dest_size -= request_size;
+    } while (dest_size > 0);
+
+    return status;
+}
+
+/* The instance is instantiated with 32 bytes of entropy & a 16-byte nonce, and
+ * then reseeded with 32 bytes of entropy. */
+AES_StatusCode aes_ctr_drbg_generate_thread_local(
+    void* dest,
+    size_t dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    unsigned char entropy[48];
+
+    if (dest == NULL && dest_size != 0)
+        return aes_error_null_argument(err_details, "dest");
+
+    status = aes_ctr_drbg_generate_thread_local_internal(dest, dest_size, entropy, err_details);
+    aes_ctr_drbg_wipe(entropy, sizeof(entropy));
+    return status;
+}
@@ -57,6 +57,10 @@ static const char* aes_strerror_messages[] = {
     "Missing padding",
     "Couldn't allocate memory",
     "Encryption mode requires init vector",
+    "Authentication failed (wrong key or corrupted data?)",
+    "Random number generator must be reseeded",
+    "Couldn't get entropy from the operating system",
+    "Destination buffer is too small",
 };
 
 _Static_assert(
@@ -140,6 +144,10 @@ static AES_ErrorFormatter err_formatters[] = {
     &aes_format_error_strerror,
     &aes_format_error_strerror,
     &aes_format_error_strerror,
+    &aes_format_error_strerror,
+    &aes_format_error_strerror,
+    &aes_format_error_strerror,
+    &aes_format_error_strerror,
 };
 
 _Static_assert(
@@ -238,3 +246,19 @@ AES_StatusCode aes_error_memory_allocation(AES_ErrorDetails* err_details) {
 AES_StatusCode aes_error_mode_requires_init_vector(AES_ErrorDetails* err_details) {
     return aes_make_error(err_details, AES_MODE_REQUIRES_INIT_VECTOR_ERROR);
 }
+
+AES_StatusCode aes_error_authentication(AES_ErrorDetails* err_details) {
+    return aes_make_error(err_details, AES_AUTHENTICATION_ERROR);
+}
+
+AES_StatusCode aes_error_reseed_required(AES_ErrorDetails* err_details) {
+    return aes_make_error(err_details, AES_RESEED_REQUIRED_ERROR);
+}
+
+AES_StatusCode aes_error_entropy_source(AES_ErrorDetails* err_details) {
+    return aes_make_error(err_details, AES_ENTROPY_SOURCE_ERROR);
+}
+
+AES_StatusCode aes_error_buffer_too_small(AES_ErrorDetails* err_details) {
+    return aes_make_error(err_details, AES_BUFFER_TOO_SMALL_ERROR);
+}
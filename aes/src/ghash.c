@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <assert.h>
+#include <stdlib.h>
+
+static const AES_GhashOps aes_ghash_clmul_ops = {
+    &aes_ghash_init_key_clmul,
+    &aes_ghash_clmul,
+};
+
+static const AES_GhashOps aes_ghash_portable_ops = {
+    &aes_ghash_init_key_portable,
+    &aes_ghash_portable,
+};
+
+static const AES_GhashOps* aes_ghash_ops_list[] = {
+    &aes_ghash_portable_ops,
+    &aes_ghash_clmul_ops,
+    &aes_ghash_portable_ops,
+    &aes_ghash_clmul_ops,
+    &aes_ghash_clmul_ops,
+};
+
+_Static_assert(
+    sizeof(aes_ghash_ops_list) / sizeof(aes_ghash_ops_list[0]) == AesImplCount,
+    "Missing implementation GHASH ops"
+);
+
+const AES_GhashOps* aes_get_impl_ghash_ops(AES_Implementation impl) {
+    if ((int)impl < 0 || impl >= AesImplCount) {
+        assert(0);
+        return NULL;
+    }
+
+    return aes_ghash_ops_list[impl];
+}
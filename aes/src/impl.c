@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+#if !defined(_MSC_VER)
+#include <stdatomic.h>
+#endif
+
+static const char* const aes_impl_names[] = {
+    "portable",
+    "aesni",
+    "vperm",
+    "vaes",
+    "vaes512",
+};
+
+_Static_assert(
+    sizeof(aes_impl_names) / sizeof(aes_impl_names[0]) == AesImplCount,
+    "Missing implementation name"
+);
+
+/* The order in which the implementations are tried, the fastest first.
+ * The portable implementation isn't constant-time, so it goes last even
+ * though it might be faster than vperm on some CPUs. */
+static const AES_Implementation aes_impl_preference[] = {
+    AES_IMPL_VAES512,
+    AES_IMPL_VAES,
+    AES_IMPL_AESNI,
+    AES_IMPL_VPERM,
+    AES_IMPL_PORTABLE,
+};
+
+static void aes_cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(_MSC_VER)
+    int max_regs[4];
+    __cpuid(max_regs, 0);
+    if ((unsigned int)max_regs[0] < leaf)
+        return;
+    __cpuidex((int*)regs, (int)leaf, (int)subleaf);
+#elif defined(__GNUC__)
+    if (__get_cpuid_max(0, NULL) < leaf)
+        return;
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+    (void)leaf;
+    (void)subleaf;
+#endif
+}
+
+static unsigned long long aes_xgetbv(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#elif defined(__GNUC__)
+    unsigned int eax, edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#else
+    return 0;
+#endif
+}
+
+/* The OS must preserve the YMM/ZMM registers across context switches. */
+static int aes_os_saves_state(unsigned long long mask) {
+    unsigned int regs[4];
+    aes_cpuid(1, 0, regs);
+    if (!((regs[2] >> 27) & 1))
+        return 0;
+    return (aes_xgetbv() & mask) == mask;
+}
+
+static int aes_cpu_has_ssse3(void) {
+    unsigned int regs[4];
+    aes_cpuid(1, 0, regs);
+    return (regs[2] >> 9) & 1;
+}
+
+/* GCM in the AES-NI implementations relies on PCLMULQDQ, every CPU with AES-NI
+ * supports it too. */
+static int aes_cpu_has_aesni(void) {
+    unsigned int regs[4];
+    aes_cpuid(1, 0, regs);
+    const int aesni = (regs[2] >> 25) & 1;
+    const int pclmulqdq = (regs[2] >> 1) & 1;
+    return aesni && pclmulqdq;
+}
+
+static int aes_cpu_has_vaes(void) {
+    unsigned int regs[4];
+    aes_cpuid(7, 0, regs);
+    const int vaes = (regs[2] >> 9) & 1;
+    const int avx2 = (regs[1] >> 5) & 1;
+    return aes_cpu_has_aesni() && vaes && avx2 && aes_os_saves_state(0x06);
+}
+
+static int aes_cpu_has_vaes512(void) {
+    unsigned int regs[4];
+    aes_cpuid(7, 0, regs);
+    const int vaes = (regs[2] >> 9) & 1;
+    const int avx512f = (regs[1] >> 16) & 1;
+    return aes_cpu_has_aesni() && vaes && avx512f && aes_os_saves_state(0xe6);
+}
+
+int aes_is_impl_supported(AES_Implementation impl) {
+    switch (impl) {
+        case AES_IMPL_PORTABLE:
+            return 1;
+        case AES_IMPL_AESNI:
+            return aes_cpu_has_aesni();
+        case AES_IMPL_VPERM:
+            return aes_cpu_has_ssse3();
+        case AES_IMPL_VAES:
+            return aes_cpu_has_vaes();
+        case AES_IMPL_VAES512:
+            return aes_cpu_has_vaes512();
+        default:
+            return 0;
+    }
+}
+
+const char* aes_get_impl_name(AES_Implementation impl) {
+    if ((int)impl < 0 || impl >= AesImplCount) {
+        assert(0);
+        return NULL;
+    }
+
+    return aes_impl_names[impl];
+}
+
+static AES_Implementation aes_select_impl(void) {
+    const char* const name = getenv("AES_TOOLS_IMPL");
+
+    if (name != NULL) {
+        for (int i = 0; i < AesImplCount; ++i)
+            if (strcmp(name, aes_impl_names[i]) == 0 && aes_is_impl_supported(i))
+                return (AES_Implementation)i;
+    }
+
+    for (size_t i = 0; i < sizeof(aes_impl_preference) / sizeof(aes_impl_preference[0]); ++i)
+        if (aes_is_impl_supported(aes_impl_preference[i]))
+            return aes_impl_preference[i];
+
+    return AES_IMPL_PORTABLE;
+}
+
+/* AesImplCount means the implementation hasn't been selected yet.
+ * Concurrent first calls might both select one, but they select the same
+ * one. The value is accessed atomically so that this isn't a data race; it
+ * doesn't guard anything else, so relaxed ordering is enough. MSVC's C11
+ * atomics are still experimental, hence the intrinsics. */
+#if defined(_MSC_VER)
+static volatile long aes_impl = AesImplCount;
+
+static AES_Implementation aes_load_impl(void) {
+    return (AES_Implementation)_InterlockedCompareExchange(&aes_impl, 0, 0);
+}
+
+static void aes_store_impl(AES_Implementation impl) {
+    _InterlockedExchange(&aes_impl, (long)impl);
+}
+#else
+static _Atomic int aes_impl = AesImplCount;
+
+static AES_Implementation aes_load_impl(void) {
+    return (AES_Implementation)atomic_load_explicit(&aes_impl, memory_order_relaxed);
+}
+
+static void aes_store_impl(AES_Implementation impl) {
+    atomic_store_explicit(&aes_impl, (int)impl, memory_order_relaxed);
+}
+#endif
+
+AES_Implementation aes_get_impl(void) {
+    AES_Implementation impl = aes_load_impl();
+
+    if (impl == AesImplCount) {
+        impl = aes_select_impl();
+        aes_store_impl(impl);
+    }
+    return impl;
+}
+
+AES_StatusCode aes_set_impl(AES_Implementation impl, AES_ErrorDetails* err_details) {
+    if (!aes_is_impl_supported(impl))
+        return aes_error_not_implemented(
+            err_details, "the implementation is not supported by this CPU"
+        );
+
+    aes_store_impl(impl);
+    return AES_SUCCESS;
+}
@@ -0,0 +1,586 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <emmintrin.h>
+#include <string.h>
+
+AES_StatusCode aes_kw_init(
+    AES_Kw* kw,
+    AES_Algorithm algorithm,
+    const AES_Key* kek,
+    AES_ErrorDetails* err_details
+) {
+    if (kw == NULL)
+        return aes_error_null_argument(err_details, "kw");
+    if (kek == NULL)
+        return aes_error_null_argument(err_details, "kek");
+
+    kw->algorithm = algorithm;
+    kw->ops = aes_get_ops(algorithm);
+
+    return kw->ops->expand_key(kek, &kw->encryption_keys, &kw->decryption_keys, err_details);
+}
+
+/* The state of a key being wrapped or unwrapped: the integrity check register
+ * A (the first 8 bytes of the block) & the n 64-bit registers R[1..n], which
+ * are kept in the destination buffer.
+ * t is the number of the next step & i is the index of the register it
+ * processes. */
+typedef struct {
+    AES_Block a;
+    unsigned char* r;
+    size_t n;
+    size_t i;
+    size_t t;
+} AES_KwState;
+
+/* In KWP mode, a single 64-bit block is wrapped using a single block
+ * encryption. */
+static size_t aes_kw_get_numof_steps(size_t n) {
+    return n == 1 ? 1 : 6 * n;
+}
+
+/* The step number t (as a 64-bit big-endian number), which is XORed with A. */
+static AES_Block aes_kw_make_t(size_t n, size_t t) {
+    if (n == 1)
+        return _mm_setzero_si128();
+    const unsigned long long t64 = t;
+    return aes_reverse_byte_order(aes_make_block((int)(t64 >> 32), (int)t64, 0, 0));
+}
+
+static AES_Block aes_kw_get_iv(void) {
+    return aes_make_block(0, 0, (int)0xa6a6a6a6, (int)0xa6a6a6a6);
+}
+
+/* The alternative IV is A65959A6 || MLI, MLI being the size of the key (as a
+ * 32-bit big-endian number). */
+static AES_Block aes_kwp_get_iv(size_t mli) {
+    return aes_reverse_byte_order(aes_make_block((int)0xa65959a6, (int)mli, 0, 0));
+}
+
+/* Every step of the wrapping process is
+ *
+ *     B = E(A || R[i]), A = MSB64(B) ^ t, R[i] = LSB64(B),
+ *
+ * and there are 6n steps, so the keys are processed step by step, every key
+ * dropping out of the batch once all of its steps are done. */
+static AES_StatusCode aes_kw_wrap_group(
+    const AES_Kw* kw,
+    AES_KwState* states,
+    size_t numof_keys,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block blocks[AES_KW_BATCH_LEN];
+    size_t indices[AES_KW_BATCH_LEN];
+
+    for (size_t k = 0; k < numof_keys; ++k) {
+        states[k].i = 0;
+        states[k].t = 1;
+    }
+
+    while (1) {
+        size_t numof_blocks = 0;
+
+        for (size_t k = 0; k < numof_keys; ++k) {
+            const AES_KwState* state = &states[k];
+            if (state->t > aes_kw_get_numof_steps(state->n))
+                continue;
+            const unsigned char* r = state->r + state->i * 8;
+            indices[numof_blocks] = k;
+            blocks[numof_blocks] = _mm_unpacklo_epi64(state->a, _mm_loadl_epi64((const __m128i*)r));
+            ++numof_blocks;
+        }
+
+        if (numof_blocks == 0)
+            return status;
+
+        status = kw->ops->encrypt_blocks(
+            blocks, numof_blocks, &kw->encryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t b = 0; b < numof_blocks; ++b) {
+            AES_KwState* state = &states[indices[b]];
+            unsigned char* r = state->r + state->i * 8;
+            state->a = aes_xor_blocks(_mm_move_epi64(blocks[b]), aes_kw_make_t(state->n, state->t));
+            _mm_storel_epi64((__m128i*)r, _mm_srli_si128(blocks[b], 8));
+
+            ++state->t;
+            if (++state->i == state->n)
+                state->i = 0;
+        }
+    }
+}
+
+/* The steps are reversed:
+ *
+ *     B = D((A ^ t) || R[i]), A = MSB64(B), R[i] = LSB64(B). */
+static AES_StatusCode aes_kw_unwrap_group(
+    const AES_Kw* kw,
+    AES_KwState* states,
+    size_t numof_keys,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_Block blocks[AES_KW_BATCH_LEN];
+    size_t indices[AES_KW_BATCH_LEN];
+
+    for (size_t k = 0; k < numof_keys; ++k) {
+        states[k].i = states[k].n - 1;
+        states[k].t = aes_kw_get_numof_steps(states[k].n);
+    }
+
+    while (1) {
+        size_t numof_blocks = 0;
+
+        for (size_t k = 0; k < numof_keys; ++k) {
+            const AES_KwState* state = &states[k];
+            if (state->t == 0)
+                continue;
+            const unsigned char* r = state->r + state->i * 8;
+            const AES_Block a = aes_xor_blocks(state->a, aes_kw_make_t(state->n, state->t));
+            indices[numof_blocks] = k;
+            blocks[numof_blocks] = _mm_unpacklo_epi64(a, _mm_loadl_epi64((const __m128i*)r));
+            ++numof_blocks;
+        }
+
+        if (numof_blocks == 0)
+            return status;
+
+        status = kw->ops->decrypt_blocks(
+            blocks, numof_blocks, &kw->decryption_keys, blocks, err_details
+        );
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t b = 0; b < numof_blocks; ++b) {
+            AES_KwState* state = &states[indices[b]];
+            unsigned char* r = state->r + state->i * 8;
+            state->a = _mm_move_epi64(blocks[b]);
+            _mm_storel_epi64((__m128i*)r, _mm_srli_si128(blocks[b], 8));
+
+            --state->t;
+            state->i = state->i == 0 ? state->n - 1 : state->i - 1;
+        }
+    }
+}
+
+static AES_StatusCode aes_kw_get_wrapped_size(
+    int padding,
+    size_t src_size,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (padding) {
+        if (src_size == 0 || (unsigned long long)src_size > 0xffffffffull)
+            return aes_error_not_implemented(err_details, "KWP keys must be 1 byte to 4 GiB long");
+
+        *dest_size = (src_size + 7) / 8 * 8 + 8;
+        return AES_SUCCESS;
+    }
+
+    if (src_size < 16 || src_size % 8 != 0)
+        return aes_error_not_implemented(
+            err_details, "KW keys must be a multiple of 8 bytes, at least 16 bytes long"
+        );
+
+    *dest_size = src_size + 8;
+    return AES_SUCCESS;
+}
+
+static int aes_kw_is_valid_wrapped_size(int padding, size_t src_size) {
+    if (src_size % 8 != 0)
+        return 0;
+    return src_size >= (padding ? 16u : 24u);
+}
+
+static int aes_kw_check(const AES_KwState* state, size_t* dest_size) {
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(state->a, aes_kw_get_iv())) != 0xffff)
+        return 0;
+
+    *dest_size = state->n * 8;
+    return 1;
+}
+
+/* The MLI must match the number of blocks, and the padding must be zero. */
+static int aes_kwp_check(const AES_KwState* state, size_t* dest_size) {
+    AES_ALIGN(unsigned char, 16) a[16];
+    aes_store_block_aligned(a, state->a);
+
+    unsigned char diff = (a[0] ^ 0xa6) | (a[1] ^ 0x59) | (a[2] ^ 0x59) | (a[3] ^ 0xa6);
+    const unsigned long mli = (unsigned long)a[4] << 24 | (unsigned long)a[5] << 16 |
+                              (unsigned long)a[6] << 8 | (unsigned long)a[7];
+
+    if (diff != 0 || mli <= 8 * (state->n - 1) || mli > 8 * state->n)
+        return 0;
+
+    for (size_t i = mli; i < 8 * state->n; ++i)
+        diff |= state->r[i];
+    if (diff != 0)
+        return 0;
+
+    *dest_size = mli;
+    return 1;
+}
+
+/* The key is copied to the destination buffer (after the space for A) &
+ * wrapped in place. */
+static AES_StatusCode aes_kw_wrap_keys(
+    const AES_Kw* kw,
+    int padding,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_KwState states[AES_KW_BATCH_LEN];
+
+    while (numof_keys > 0) {
+        const size_t batch_len = numof_keys < AES_KW_BATCH_LEN ? numof_keys : AES_KW_BATCH_LEN;
+
+        for (size_t k = 0; k < batch_len; ++k) {
+            unsigned char* dest = (unsigned char*)dests[k];
+            const size_t src_size = src_sizes[k];
+            const size_t n = (src_size + 7) / 8;
+
+            states[k].a = padding ? aes_kwp_get_iv(src_size) : aes_kw_get_iv();
+            states[k].r = dest + 8;
+            states[k].n = n;
+
+            memmove(dest + 8, srcs[k], src_size);
+            memset(dest + 8 + src_size, 0x00, n * 8 - src_size);
+            dest_sizes[k] = n * 8 + 8;
+        }
+
+        status = aes_kw_wrap_group(kw, states, batch_len, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t k = 0; k < batch_len; ++k)
+            _mm_storel_epi64((__m128i*)dests[k], states[k].a);
+
+        srcs += batch_len;
+        src_sizes += batch_len;
+        dests += batch_len;
+        dest_sizes += batch_len;
+        numof_keys -= batch_len;
+    }
+
+    return status;
+}
+
+/* The registers R[1..n] are copied to the destination buffer & unwrapped in
+ * place. */
+static AES_StatusCode aes_kw_unwrap_keys(
+    const AES_Kw* kw,
+    int padding,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+    AES_KwState states[AES_KW_BATCH_LEN];
+    size_t indices[AES_KW_BATCH_LEN];
+    int failed = 0;
+
+    while (numof_keys > 0) {
+        const size_t batch_len = numof_keys < AES_KW_BATCH_LEN ? numof_keys : AES_KW_BATCH_LEN;
+        size_t numof_states = 0;
+
+        for (size_t k = 0; k < batch_len; ++k) {
+            if (!aes_kw_is_valid_wrapped_size(padding, src_sizes[k])) {
+                dest_sizes[k] = 0;
+                failed = 1;
+                continue;
+            }
+
+            const unsigned char* src = (const unsigned char*)srcs[k];
+            AES_KwState* state = &states[numof_states];
+
+            state->a = _mm_loadl_epi64((const __m128i*)src);
+            state->r = (unsigned char*)dests[k];
+            state->n = src_sizes[k] / 8 - 1;
+
+            memmove(state->r, src + 8, state->n * 8);
+            indices[numof_states++] = k;
+        }
+
+        status = aes_kw_unwrap_group(kw, states, numof_states, err_details);
+        if (aes_is_error(status))
+            return status;
+
+        for (size_t s = 0; s < numof_states; ++s) {
+            const AES_KwState* state = &states[s];
+            size_t* dest_size = &dest_sizes[indices[s]];
+
+            const int ok =
+                padding ? aes_kwp_check(state, dest_size) : aes_kw_check(state, dest_size);
+            if (!ok) {
+                memset(state->r, 0x00, state->n * 8);
+                *dest_size = 0;
+                failed = 1;
+            }
+        }
+
+        srcs += batch_len;
+        src_sizes += batch_len;
+        dests += batch_len;
+        dest_sizes += batch_len;
+        numof_keys -= batch_len;
+    }
+
+    if (failed)
+        return aes_error_authentication(err_details);
+    return status;
+}
+
+static AES_StatusCode aes_kw_wrap_one(
+    const AES_Kw* kw,
+    int padding,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    if (kw == NULL)
+        return aes_error_null_argument(err_details, "kw");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    status = aes_kw_get_wrapped_size(padding, src_size, dest_size, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    if (dest == NULL)
+        return AES_SUCCESS;
+    if (src == NULL)
+        return aes_error_null_argument(err_details, "src");
+
+    return aes_kw_wrap_keys(kw, padding, &src, &src_size, 1, &dest, dest_size, err_details);
+}
+
+static AES_StatusCode aes_kw_unwrap_one(
+    const AES_Kw* kw,
+    int padding,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    if (kw == NULL)
+        return aes_error_null_argument(err_details, "kw");
+    if (dest_size == NULL)
+        return aes_error_null_argument(err_details, "dest_size");
+
+    if (!aes_kw_is_valid_wrapped_size(padding, src_size))
+        return aes_error_authentication(err_details);
+
+    *dest_size = src_size - 8;
+
+    if (dest == NULL)
+        return AES_SUCCESS;
+    if (src == NULL)
+        return aes_error_null_argument(err_details, "src");
+
+    return aes_kw_unwrap_keys(kw, padding, &src, &src_size, 1, &dest, dest_size, err_details);
+}
+
+static AES_StatusCode aes_kw_check_batch_args(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    if (kw == NULL)
+        return aes_error_null_argument(err_details, "kw");
+    if (numof_keys == 0)
+        return AES_SUCCESS;
+    if (srcs == NULL)
+        return aes_error_null_argument(err_details, "srcs");
+    if (src_sizes == NULL)
+        return aes_error_null_argument(err_details, "src_sizes");
+    if (dests == NULL)
+        return aes_error_null_argument(err_details, "dests");
+    if (dest_sizes == NULL)
+        return aes_error_null_argument(err_details, "dest_sizes");
+
+    for (size_t k = 0; k < numof_keys; ++k) {
+        if (srcs[k] == NULL)
+            return aes_error_null_argument(err_details, "srcs");
+        if (dests[k] == NULL)
+            return aes_error_null_argument(err_details, "dests");
+    }
+
+    return AES_SUCCESS;
+}
+
+static AES_StatusCode aes_kw_wrap_batch_internal(
+    const AES_Kw* kw,
+    int padding,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    status =
+        aes_kw_check_batch_args(kw, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    for (size_t k = 0; k < numof_keys; ++k) {
+        status = aes_kw_get_wrapped_size(padding, src_sizes[k], &dest_sizes[k], err_details);
+        if (aes_is_error(status))
+            return status;
+    }
+
+    return aes_kw_wrap_keys(
+        kw, padding, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
+
+static AES_StatusCode aes_kw_unwrap_batch_internal(
+    const AES_Kw* kw,
+    int padding,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    AES_StatusCode status = AES_SUCCESS;
+
+    status =
+        aes_kw_check_batch_args(kw, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details);
+    if (aes_is_error(status))
+        return status;
+
+    return aes_kw_unwrap_keys(
+        kw, padding, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
+
+AES_StatusCode aes_kw_wrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_wrap_one(kw, 0, src, src_size, dest, dest_size, err_details);
+}
+
+AES_StatusCode aes_kw_unwrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_unwrap_one(kw, 0, src, src_size, dest, dest_size, err_details);
+}
+
+AES_StatusCode aes_kwp_wrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_wrap_one(kw, 1, src, src_size, dest, dest_size, err_details);
+}
+
+AES_StatusCode aes_kwp_unwrap(
+    const AES_Kw* kw,
+    const void* src,
+    size_t src_size,
+    void* dest,
+    size_t* dest_size,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_unwrap_one(kw, 1, src, src_size, dest, dest_size, err_details);
+}
+
+AES_StatusCode aes_kw_wrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_wrap_batch_internal(
+        kw, 0, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
+
+AES_StatusCode aes_kw_unwrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_unwrap_batch_internal(
+        kw, 0, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
+
+AES_StatusCode aes_kwp_wrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_wrap_batch_internal(
+        kw, 1, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
+
+AES_StatusCode aes_kwp_unwrap_batch(
+    const AES_Kw* kw,
+    const void* const* srcs,
+    const size_t* src_sizes,
+    size_t numof_keys,
+    void* const* dests,
+    size_t* dest_sizes,
+    AES_ErrorDetails* err_details
+) {
+    return aes_kw_unwrap_batch_internal(
+        kw, 1, srcs, src_sizes, numof_keys, dests, dest_sizes, err_details
+    );
+}
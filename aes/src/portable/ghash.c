@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <stdint.h>
+
+/* Carry-less multiplication using ordinary integer multiplication, as in
+ * BearSSL's ghash_ctmul64.
+ * Only every fourth bit of the operands is kept, so that the carries land in
+ * the bits that are masked out afterwards.
+ * There are no tables & no branches on the data, so it's constant-time. */
+
+static uint64_t aes_ghash_bmul64(uint64_t x, uint64_t y) {
+    const uint64_t m0 = UINT64_C(0x1111111111111111);
+    const uint64_t m1 = UINT64_C(0x2222222222222222);
+    const uint64_t m2 = UINT64_C(0x4444444444444444);
+    const uint64_t m3 = UINT64_C(0x8888888888888888);
+
+    const uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    const uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+
+    const uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    const uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    const uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    const uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+static uint64_t aes_ghash_rev64(uint64_t x) {
+    x = ((x & UINT64_C(0x5555555555555555)) << 1) | ((x >> 1) & UINT64_C(0x5555555555555555));
+    x = ((x & UINT64_C(0x3333333333333333)) << 2) | ((x >> 2) & UINT64_C(0x3333333333333333));
+    x = ((x & UINT64_C(0x0f0f0f0f0f0f0f0f)) << 4) | ((x >> 4) & UINT64_C(0x0f0f0f0f0f0f0f0f));
+    x = ((x & UINT64_C(0x00ff00ff00ff00ff)) << 8) | ((x >> 8) & UINT64_C(0x00ff00ff00ff00ff));
+    x = ((x & UINT64_C(0x0000ffff0000ffff)) << 16) | ((x >> 16) & UINT64_C(0x0000ffff0000ffff));
+    return (x << 32) | (x >> 32);
+}
+
+static uint64_t aes_ghash_load_be64(const unsigned char* src) {
+    uint64_t x = 0;
+    for (int i = 0; i < 8; ++i)
+        x = (x << 8) | src[i];
+    return x;
+}
+
+static void aes_ghash_store_be64(unsigned char* dest, uint64_t x) {
+    for (int i = 7; i >= 0; --i, x >>= 8)
+        dest[i] = (unsigned char)x;
+}
+
+/* Only key->powers[0] (H itself) is used. */
+void aes_ghash_init_key_portable(AES_GhashKey* key, AES_Block h) {
+    for (int i = 0; i < AES_GHASH_NUMOF_POWERS; ++i)
+        key->powers[i] = h;
+}
+
+AES_Block aes_ghash_portable(
+    AES_Block hash,
+    const void* src,
+    size_t numof_blocks,
+    const AES_GhashKey* key
+) {
+    AES_ALIGN(unsigned char, 16) bytes[16];
+
+    /* y1/h1 are the first 8 bytes, y0/h0 are the last 8 bytes. */
+    aes_store_block_aligned(bytes, key->powers[0]);
+    const uint64_t h1 = aes_ghash_load_be64(bytes);
+    const uint64_t h0 = aes_ghash_load_be64(bytes + 8);
+    const uint64_t h2 = h0 ^ h1;
+    const uint64_t h0r = aes_ghash_rev64(h0);
+    const uint64_t h1r = aes_ghash_rev64(h1);
+    const uint64_t h2r = h0r ^ h1r;
+
+    aes_store_block_aligned(bytes, hash);
+    uint64_t y1 = aes_ghash_load_be64(bytes);
+    uint64_t y0 = aes_ghash_load_be64(bytes + 8);
+
+    const unsigned char* input = (const unsigned char*)src;
+
+    for (size_t i = 0; i < numof_blocks; ++i, input += sizeof(AES_Block)) {
+        y1 ^= aes_ghash_load_be64(input);
+        y0 ^= aes_ghash_load_be64(input + 8);
+
+        const uint64_t y2 = y0 ^ y1;
+        const uint64_t y0r = aes_ghash_rev64(y0);
+        const uint64_t y1r = aes_ghash_rev64(y1);
+        const uint64_t y2r = y0r ^ y1r;
+
+        /* Karatsuba: the low halves of the products come from the operands
+         * themselves, the high halves from the bit-reversed operands. */
+        const uint64_t z0 = aes_ghash_bmul64(y0, h0);
+        const uint64_t z1 = aes_ghash_bmul64(y1, h1);
+        const uint64_t z2 = aes_ghash_bmul64(y2, h2) ^ z0 ^ z1;
+        uint64_t z0h = aes_ghash_bmul64(y0r, h0r);
+        uint64_t z1h = aes_ghash_bmul64(y1r, h1r);
+        uint64_t z2h = aes_ghash_bmul64(y2r, h2r) ^ z0h ^ z1h;
+
+        z0h = aes_ghash_rev64(z0h) >> 1;
+        z1h = aes_ghash_rev64(z1h) >> 1;
+        z2h = aes_ghash_rev64(z2h) >> 1;
+
+        /* The 256-bit product is v3:v2:v1:v0, shift it left by one bit
+         * (because the bits are reflected) & reduce. */
+        uint64_t v0 = z0;
+        uint64_t v1 = z0h ^ z2;
+        uint64_t v2 = z1 ^ z2h;
+        uint64_t v3 = z1h;
+
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        y0 = v2;
+        y1 = v3;
+    }
+
+    aes_ghash_store_be64(bytes, y1);
+    aes_ghash_store_be64(bytes + 8, y0);
+    return aes_load_block_aligned(bytes);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+/* A VAES instruction runs an AES round on the two blocks in a YMM register.
+ * Its latency is several cycles, so eight registers are processed in
+ * lockstep. */
+
+/* Short calls often follow the caller storing the blocks one at a time (CCM
+ * does that for every block), and a 32-byte load can't be forwarded from two
+ * 16-byte stores.
+ * So the blocks left over from the main loop are loaded one at a time. */
+static inline __m256i aes_vaes_load2(const AES_Block* src) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(src)), _mm_loadu_si128(src + 1), 1
+    );
+}
+
+static void aes_vaes_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    __m256i k[15];
+    for (int i = 0; i <= numof_rounds; ++i)
+        k[i] = _mm256_broadcastsi128_si256(keys[i]);
+    const __m256i last = k[numof_rounds];
+
+    for (; numof_blocks >= 16; numof_blocks -= 16, plaintext += 16, ciphertext += 16) {
+        __m256i b0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 0)), k[0]);
+        __m256i b1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 2)), k[0]);
+        __m256i b2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 4)), k[0]);
+        __m256i b3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 6)), k[0]);
+        __m256i b4 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 8)), k[0]);
+        __m256i b5 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 10)), k[0]);
+        __m256i b6 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 12)), k[0]);
+        __m256i b7 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + 14)), k[0]);
+
+        for (int i = 1; i < numof_rounds; ++i) {
+            b0 = _mm256_aesenc_epi128(b0, k[i]);
+            b1 = _mm256_aesenc_epi128(b1, k[i]);
+            b2 = _mm256_aesenc_epi128(b2, k[i]);
+            b3 = _mm256_aesenc_epi128(b3, k[i]);
+            b4 = _mm256_aesenc_epi128(b4, k[i]);
+            b5 = _mm256_aesenc_epi128(b5, k[i]);
+            b6 = _mm256_aesenc_epi128(b6, k[i]);
+            b7 = _mm256_aesenc_epi128(b7, k[i]);
+        }
+
+        _mm256_storeu_si256((__m256i*)(ciphertext + 0), _mm256_aesenclast_epi128(b0, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 2), _mm256_aesenclast_epi128(b1, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 4), _mm256_aesenclast_epi128(b2, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 6), _mm256_aesenclast_epi128(b3, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 8), _mm256_aesenclast_epi128(b4, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 10), _mm256_aesenclast_epi128(b5, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 12), _mm256_aesenclast_epi128(b6, last));
+        _mm256_storeu_si256((__m256i*)(ciphertext + 14), _mm256_aesenclast_epi128(b7, last));
+    }
+
+    for (; numof_blocks >= 2; numof_blocks -= 2, plaintext += 2, ciphertext += 2) {
+        __m256i b0 = _mm256_xor_si256(aes_vaes_load2(plaintext), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm256_aesenc_epi128(b0, k[i]);
+        _mm256_storeu_si256((__m256i*)ciphertext, _mm256_aesenclast_epi128(b0, last));
+    }
+
+    if (numof_blocks > 0) {
+        __m256i b0 = _mm256_xor_si256(_mm256_castsi128_si256(_mm_loadu_si128(plaintext)), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm256_aesenc_epi128(b0, k[i]);
+        _mm_storeu_si128(ciphertext, _mm256_castsi256_si128(_mm256_aesenclast_epi128(b0, last)));
+    }
+}
+
+static void aes_vaes_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    __m256i k[15];
+    for (int i = 0; i <= numof_rounds; ++i)
+        k[i] = _mm256_broadcastsi128_si256(keys[i]);
+    const __m256i last = k[numof_rounds];
+
+    for (; numof_blocks >= 16; numof_blocks -= 16, ciphertext += 16, plaintext += 16) {
+        __m256i b0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 0)), k[0]);
+        __m256i b1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 2)), k[0]);
+        __m256i b2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 4)), k[0]);
+        __m256i b3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 6)), k[0]);
+        __m256i b4 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 8)), k[0]);
+        __m256i b5 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 10)), k[0]);
+        __m256i b6 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 12)), k[0]);
+        __m256i b7 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(ciphertext + 14)), k[0]);
+
+        for (int i = 1; i < numof_rounds; ++i) {
+            b0 = _mm256_aesdec_epi128(b0, k[i]);
+            b1 = _mm256_aesdec_epi128(b1, k[i]);
+            b2 = _mm256_aesdec_epi128(b2, k[i]);
+            b3 = _mm256_aesdec_epi128(b3, k[i]);
+            b4 = _mm256_aesdec_epi128(b4, k[i]);
+            b5 = _mm256_aesdec_epi128(b5, k[i]);
+            b6 = _mm256_aesdec_epi128(b6, k[i]);
+            b7 = _mm256_aesdec_epi128(b7, k[i]);
+        }
+
+        _mm256_storeu_si256((__m256i*)(plaintext + 0), _mm256_aesdeclast_epi128(b0, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 2), _mm256_aesdeclast_epi128(b1, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 4), _mm256_aesdeclast_epi128(b2, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 6), _mm256_aesdeclast_epi128(b3, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 8), _mm256_aesdeclast_epi128(b4, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 10), _mm256_aesdeclast_epi128(b5, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 12), _mm256_aesdeclast_epi128(b6, last));
+        _mm256_storeu_si256((__m256i*)(plaintext + 14), _mm256_aesdeclast_epi128(b7, last));
+    }
+
+    for (; numof_blocks >= 2; numof_blocks -= 2, ciphertext += 2, plaintext += 2) {
+        __m256i b0 = _mm256_xor_si256(aes_vaes_load2(ciphertext), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm256_aesdec_epi128(b0, k[i]);
+        _mm256_storeu_si256((__m256i*)plaintext, _mm256_aesdeclast_epi128(b0, last));
+    }
+
+    if (numof_blocks > 0) {
+        __m256i b0 = _mm256_xor_si256(_mm256_castsi128_si256(_mm_loadu_si128(ciphertext)), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm256_aesdec_epi128(b0, k[i]);
+        _mm_storeu_si128(plaintext, _mm256_castsi256_si128(_mm256_aesdeclast_epi128(b0, last)));
+    }
+}
+
+void aes128_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_vaes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 10);
+}
+
+void aes128_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+) {
+    aes_vaes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 10);
+}
+
+void aes192_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_vaes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 12);
+}
+
+void aes192_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+) {
+    aes_vaes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 12);
+}
+
+void aes256_encrypt_blocks_vaes(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_vaes_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 14);
+}
+
+void aes256_decrypt_blocks_vaes(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+) {
+    aes_vaes_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 14);
+}
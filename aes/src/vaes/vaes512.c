@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include <aes/all.h>
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+/* A VAES instruction runs an AES round on the four blocks in a ZMM register.
+ * Its latency is several cycles, so eight registers are processed in
+ * lockstep. */
+
+/* Short calls often follow the caller storing the blocks one at a time (CCM
+ * does that for every block), and a wide load can't be forwarded from
+ * several narrower stores.
+ * So the blocks left over from the main loop are loaded one at a time, and the
+ * partial groups are stored one block at a time, too (a masked store can't be
+ * forwarded to the loads that follow it). */
+static inline __m512i aes_vaes512_load(const AES_Block* src, size_t numof_blocks) {
+    __m512i dest = _mm512_castsi128_si512(_mm_loadu_si128(src));
+    if (numof_blocks > 1)
+        dest = _mm512_inserti32x4(dest, _mm_loadu_si128(src + 1), 1);
+    if (numof_blocks > 2)
+        dest = _mm512_inserti32x4(dest, _mm_loadu_si128(src + 2), 2);
+    if (numof_blocks > 3)
+        dest = _mm512_inserti32x4(dest, _mm_loadu_si128(src + 3), 3);
+    return dest;
+}
+
+static inline void aes_vaes512_store(AES_Block* dest, __m512i src, size_t numof_blocks) {
+    _mm_storeu_si128(dest, _mm512_castsi512_si128(src));
+    if (numof_blocks > 1)
+        _mm_storeu_si128(dest + 1, _mm512_extracti32x4_epi32(src, 1));
+    if (numof_blocks > 2)
+        _mm_storeu_si128(dest + 2, _mm512_extracti32x4_epi32(src, 2));
+}
+
+static void aes_vaes512_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    __m512i k[15];
+    for (int i = 0; i <= numof_rounds; ++i)
+        k[i] = _mm512_broadcast_i32x4(keys[i]);
+    const __m512i last = k[numof_rounds];
+
+    for (; numof_blocks >= 32; numof_blocks -= 32, plaintext += 32, ciphertext += 32) {
+        __m512i b0 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 0), k[0]);
+        __m512i b1 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 4), k[0]);
+        __m512i b2 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 8), k[0]);
+        __m512i b3 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 12), k[0]);
+        __m512i b4 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 16), k[0]);
+        __m512i b5 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 20), k[0]);
+        __m512i b6 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 24), k[0]);
+        __m512i b7 = _mm512_xor_si512(_mm512_loadu_si512(plaintext + 28), k[0]);
+
+        for (int i = 1; i < numof_rounds; ++i) {
+            b0 = _mm512_aesenc_epi128(b0, k[i]);
+            b1 = _mm512_aesenc_epi128(b1, k[i]);
+            b2 = _mm512_aesenc_epi128(b2, k[i]);
+            b3 = _mm512_aesenc_epi128(b3, k[i]);
+            b4 = _mm512_aesenc_epi128(b4, k[i]);
+            b5 = _mm512_aesenc_epi128(b5, k[i]);
+            b6 = _mm512_aesenc_epi128(b6, k[i]);
+            b7 = _mm512_aesenc_epi128(b7, k[i]);
+        }
+
+        _mm512_storeu_si512(ciphertext + 0, _mm512_aesenclast_epi128(b0, last));
+        _mm512_storeu_si512(ciphertext + 4, _mm512_aesenclast_epi128(b1, last));
+        _mm512_storeu_si512(ciphertext + 8, _mm512_aesenclast_epi128(b2, last));
+        _mm512_storeu_si512(ciphertext + 12, _mm512_aesenclast_epi128(b3, last));
+        _mm512_storeu_si512(ciphertext + 16, _mm512_aesenclast_epi128(b4, last));
+        _mm512_storeu_si512(ciphertext + 20, _mm512_aesenclast_epi128(b5, last));
+        _mm512_storeu_si512(ciphertext + 24, _mm512_aesenclast_epi128(b6, last));
+        _mm512_storeu_si512(ciphertext + 28, _mm512_aesenclast_epi128(b7, last));
+    }
+
+    for (; numof_blocks >= 4; numof_blocks -= 4, plaintext += 4, ciphertext += 4) {
+        __m512i b0 = _mm512_xor_si512(aes_vaes512_load(plaintext, 4), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm512_aesenc_epi128(b0, k[i]);
+        _mm512_storeu_si512(ciphertext, _mm512_aesenclast_epi128(b0, last));
+    }
+
+    if (numof_blocks > 0) {
+        __m512i b0 = _mm512_xor_si512(aes_vaes512_load(plaintext, numof_blocks), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm512_aesenc_epi128(b0, k[i]);
+        aes_vaes512_store(ciphertext, _mm512_aesenclast_epi128(b0, last), numof_blocks);
+    }
+}
+
+static void aes_vaes512_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    __m512i k[15];
+    for (int i = 0; i <= numof_rounds; ++i)
+        k[i] = _mm512_broadcast_i32x4(keys[i]);
+    const __m512i last = k[numof_rounds];
+
+    for (; numof_blocks >= 32; numof_blocks -= 32, ciphertext += 32, plaintext += 32) {
+        __m512i b0 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 0), k[0]);
+        __m512i b1 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 4), k[0]);
+        __m512i b2 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 8), k[0]);
+        __m512i b3 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 12), k[0]);
+        __m512i b4 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 16), k[0]);
+        __m512i b5 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 20), k[0]);
+        __m512i b6 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 24), k[0]);
+        __m512i b7 = _mm512_xor_si512(_mm512_loadu_si512(ciphertext + 28), k[0]);
+
+        for (int i = 1; i < numof_rounds; ++i) {
+            b0 = _mm512_aesdec_epi128(b0, k[i]);
+            b1 = _mm512_aesdec_epi128(b1, k[i]);
+            b2 = _mm512_aesdec_epi128(b2, k[i]);
+            b3 = _mm512_aesdec_epi128(b3, k[i]);
+            b4 = _mm512_aesdec_epi128(b4, k[i]);
+            b5 = _mm512_aesdec_epi128(b5, k[i]);
+            b6 = _mm512_aesdec_epi128(b6, k[i]);
+            b7 = _mm512_aesdec_epi128(b7, k[i]);
+        }
+
+        _mm512_storeu_si512(plaintext + 0, _mm512_aesdeclast_epi128(b0, last));
+        _mm512_storeu_si512(plaintext + 4, _mm512_aesdeclast_epi128(b1, last));
+        _mm512_storeu_si512(plaintext + 8, _mm512_aesdeclast_epi128(b2, last));
+        _mm512_storeu_si512(plaintext + 12, _mm512_aesdeclast_epi128(b3, last));
+        _mm512_storeu_si512(plaintext + 16, _mm512_aesdeclast_epi128(b4, last));
+        _mm512_storeu_si512(plaintext + 20, _mm512_aesdeclast_epi128(b5, last));
+        _mm512_storeu_si512(plaintext + 24, _mm512_aesdeclast_epi128(b6, last));
+        _mm512_storeu_si512(plaintext + 28, _mm512_aesdeclast_epi128(b7, last));
+    }
+
+    for (; numof_blocks >= 4; numof_blocks -= 4, ciphertext += 4, plaintext += 4) {
+        __m512i b0 = _mm512_xor_si512(aes_vaes512_load(ciphertext, 4), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm512_aesdec_epi128(b0, k[i]);
+        _mm512_storeu_si512(plaintext, _mm512_aesdeclast_epi128(b0, last));
+    }
+
+    if (numof_blocks > 0) {
+        __m512i b0 = _mm512_xor_si512(aes_vaes512_load(ciphertext, numof_blocks), k[0]);
+        for (int i = 1; i < numof_rounds; ++i)
+            b0 = _mm512_aesdec_epi128(b0, k[i]);
+        aes_vaes512_store(plaintext, _mm512_aesdeclast_epi128(b0, last), numof_blocks);
+    }
+}
+
+void aes128_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_vaes512_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 10);
+}
+
+void aes128_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+) {
+    aes_vaes512_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 10);
+}
+
+void aes192_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_vaes512_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 12);
+}
+
+void aes192_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+) {
+    aes_vaes512_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 12);
+}
+
+void aes256_encrypt_blocks_vaes512(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_vaes512_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 14);
+}
+
+void aes256_decrypt_blocks_vaes512(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+) {
+    aes_vaes512_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 14);
+}
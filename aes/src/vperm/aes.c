@@ -0,0 +1,839 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+/* A constant-time implementation for CPUs without AES-NI, based on Mike
+ * Hamburg's "Accelerating AES with Vector Permute Instructions" (public
+ * domain, see https://shiftleft.org/papers/vector_aes/).
+ *
+ * The S-box is computed by inverting in GF((2^4)^2), which only requires
+ * 16-entry tables.  These are looked up using PSHUFB, so there're no
+ * data-dependent memory accesses.
+ * The state is kept in a different basis, and the round keys are
+ * transformed accordingly.  The round keys are therefore NOT compatible
+ * with the other implementations. */
+
+#include <aes/all.h>
+
+#include <emmintrin.h>
+#include <stdlib.h>
+#include <tmmintrin.h>
+
+/* 1/x in GF(2^4) & the helper table for inverting in GF(2^8) through GF((2^4)^2). */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_inv[2][16] = {
+    {0x80, 0x01, 0x08, 0x0d, 0x0f, 0x06, 0x05, 0x0e,
+     0x02, 0x0c, 0x0b, 0x0a, 0x09, 0x03, 0x07, 0x04},
+    {0x80, 0x07, 0x0b, 0x0f, 0x06, 0x0a, 0x04, 0x01,
+     0x09, 0x08, 0x05, 0x02, 0x0c, 0x0e, 0x0d, 0x03},
+};
+
+/* The input transform into the internal basis. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_ipt[2][16] = {
+    {0x00, 0x70, 0x2a, 0x5a, 0x98, 0xe8, 0xb2, 0xc2,
+     0x08, 0x78, 0x22, 0x52, 0x90, 0xe0, 0xba, 0xca},
+    {0x00, 0x4d, 0x7c, 0x31, 0x7d, 0x30, 0x01, 0x4c,
+     0x81, 0xcc, 0xfd, 0xb0, 0xfc, 0xb1, 0x80, 0xcd},
+};
+
+/* The S-box output, multiplied by 1 & 2 for MixColumns, & the one for the last round. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_sb1[2][16] = {
+    {0x00, 0x3e, 0x50, 0xcb, 0x8f, 0xe1, 0x9b, 0xb1,
+     0x44, 0xf5, 0x2a, 0x14, 0x6e, 0x7a, 0xdf, 0xa5},
+    {0x00, 0x23, 0xe2, 0xfa, 0x15, 0xd4, 0x18, 0x36,
+     0xef, 0xd9, 0x2e, 0x0d, 0xc1, 0xcc, 0xf7, 0x3b},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_sb2[2][16] = {
+    {0x00, 0x24, 0x71, 0x0b, 0xc6, 0x93, 0x7a, 0xe2,
+     0xcd, 0x2f, 0x98, 0xbc, 0x55, 0xe9, 0xb7, 0x5e},
+    {0x00, 0x29, 0xe1, 0x0a, 0x40, 0x88, 0xeb, 0x69,
+     0x4a, 0x23, 0x82, 0xab, 0xc8, 0x63, 0xa1, 0xc2},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_sbo[2][16] = {
+    {0x00, 0xc7, 0xbd, 0x6f, 0x17, 0x6d, 0xd2, 0xd0,
+     0x78, 0xa8, 0x02, 0xc5, 0x7a, 0xbf, 0xaa, 0x15},
+    {0x00, 0x6a, 0xbb, 0x5f, 0xa5, 0x74, 0xe4, 0xcf,
+     0xfa, 0x35, 0x2b, 0x41, 0xd1, 0x90, 0x1e, 0x8e},
+};
+
+/* Rotations of the columns for MixColumns. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_mc_forward[4][16] = {
+    {0x01, 0x02, 0x03, 0x00, 0x05, 0x06, 0x07, 0x04,
+     0x09, 0x0a, 0x0b, 0x08, 0x0d, 0x0e, 0x0f, 0x0c},
+    {0x05, 0x06, 0x07, 0x04, 0x09, 0x0a, 0x0b, 0x08,
+     0x0d, 0x0e, 0x0f, 0x0c, 0x01, 0x02, 0x03, 0x00},
+    {0x09, 0x0a, 0x0b, 0x08, 0x0d, 0x0e, 0x0f, 0x0c,
+     0x01, 0x02, 0x03, 0x00, 0x05, 0x06, 0x07, 0x04},
+    {0x0d, 0x0e, 0x0f, 0x0c, 0x01, 0x02, 0x03, 0x00,
+     0x05, 0x06, 0x07, 0x04, 0x09, 0x0a, 0x0b, 0x08},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_mc_backward[4][16] = {
+    {0x03, 0x00, 0x01, 0x02, 0x07, 0x04, 0x05, 0x06,
+     0x0b, 0x08, 0x09, 0x0a, 0x0f, 0x0c, 0x0d, 0x0e},
+    {0x0f, 0x0c, 0x0d, 0x0e, 0x03, 0x00, 0x01, 0x02,
+     0x07, 0x04, 0x05, 0x06, 0x0b, 0x08, 0x09, 0x0a},
+    {0x0b, 0x08, 0x09, 0x0a, 0x0f, 0x0c, 0x0d, 0x0e,
+     0x03, 0x00, 0x01, 0x02, 0x07, 0x04, 0x05, 0x06},
+    {0x07, 0x04, 0x05, 0x06, 0x0b, 0x08, 0x09, 0x0a,
+     0x0f, 0x0c, 0x0d, 0x0e, 0x03, 0x00, 0x01, 0x02},
+};
+
+/* ShiftRows, applied to the output of the last round. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_sr[4][16] = {
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+     0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+    {0x00, 0x05, 0x0a, 0x0f, 0x04, 0x09, 0x0e, 0x03,
+     0x08, 0x0d, 0x02, 0x07, 0x0c, 0x01, 0x06, 0x0b},
+    {0x00, 0x09, 0x02, 0x0b, 0x04, 0x0d, 0x06, 0x0f,
+     0x08, 0x01, 0x0a, 0x03, 0x0c, 0x05, 0x0e, 0x07},
+    {0x00, 0x0d, 0x0a, 0x07, 0x04, 0x01, 0x0e, 0x0b,
+     0x08, 0x05, 0x02, 0x0f, 0x0c, 0x09, 0x06, 0x03},
+};
+
+/* The key schedule: the round constants & the output transforms. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_rcon[16] = {
+    0xb6, 0xee, 0x9d, 0xaf, 0xb9, 0x91, 0x83, 0x1f,
+    0x81, 0x7d, 0x7c, 0x4d, 0x08, 0x98, 0x2a, 0x70,
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_opt[2][16] = {
+    {0x00, 0x60, 0xb6, 0xd6, 0x29, 0x49, 0x9f, 0xff,
+     0x08, 0x68, 0xbe, 0xde, 0x21, 0x41, 0x97, 0xf7},
+    {0x00, 0xec, 0xbc, 0x50, 0x51, 0xbd, 0xed, 0x01,
+     0xe0, 0x0c, 0x5c, 0xb0, 0xb1, 0x5d, 0x0d, 0xe1},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_deskew[2][16] = {
+    {0x00, 0xe3, 0xa4, 0x47, 0x40, 0xa3, 0xe4, 0x07,
+     0x1a, 0xf9, 0xbe, 0x5d, 0x5a, 0xb9, 0xfe, 0x1d},
+    {0x00, 0x69, 0xea, 0x83, 0xdc, 0xb5, 0x36, 0x5f,
+     0x77, 0x1e, 0x9d, 0xf4, 0xab, 0xc2, 0x41, 0x28},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dksd[2][16] = {
+    {0x00, 0x47, 0xe4, 0xa3, 0x5d, 0x1a, 0xb9, 0xfe,
+     0xf9, 0xbe, 0x1d, 0x5a, 0xa4, 0xe3, 0x40, 0x07},
+    {0x00, 0x83, 0x36, 0xb5, 0xf4, 0x77, 0xc2, 0x41,
+     0x1e, 0x9d, 0x28, 0xab, 0xea, 0x69, 0xdc, 0x5f},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dksb[2][16] = {
+    {0x00, 0xd5, 0x50, 0x85, 0x1f, 0xca, 0x4f, 0x9a,
+     0x99, 0x4c, 0xc9, 0x1c, 0x86, 0x53, 0xd6, 0x03},
+    {0x00, 0x4a, 0xfc, 0xb6, 0xa7, 0xed, 0x5b, 0x11,
+     0xc8, 0x82, 0x34, 0x7e, 0x6f, 0x25, 0x93, 0xd9},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dkse[2][16] = {
+    {0x00, 0xd6, 0xc9, 0x1f, 0xca, 0x1c, 0x03, 0xd5,
+     0x86, 0x50, 0x4f, 0x99, 0x4c, 0x9a, 0x85, 0x53},
+    {0xe8, 0x7b, 0xdc, 0x4f, 0x05, 0x96, 0x31, 0xa2,
+     0x87, 0x14, 0xb3, 0x20, 0x6a, 0xf9, 0x5e, 0xcd},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dks9[2][16] = {
+    {0x00, 0xa7, 0xd9, 0x7e, 0xc8, 0x6f, 0x11, 0xb6,
+     0xfc, 0x5b, 0x25, 0x82, 0x34, 0x93, 0xed, 0x4a},
+    {0x00, 0x33, 0x14, 0x27, 0x62, 0x51, 0x76, 0x45,
+     0xce, 0xfd, 0xda, 0xe9, 0xac, 0x9f, 0xb8, 0x8b},
+};
+
+/* Decryption: the input transform & the output tables, multiplied by 9, D, B & E for
+ * InvMixColumns. */
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dipt[2][16] = {
+    {0x00, 0x5f, 0x54, 0x0b, 0x04, 0x5b, 0x50, 0x0f,
+     0x1a, 0x45, 0x4e, 0x11, 0x1e, 0x41, 0x4a, 0x15},
+    {0x00, 0x65, 0x05, 0x60, 0xe6, 0x83, 0xe3, 0x86,
+     0x94, 0xf1, 0x91, 0xf4, 0x72, 0x17, 0x77, 0x12},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dsb9[2][16] = {
+    {0x00, 0xd6, 0x86, 0x9a, 0x53, 0x03, 0x1c, 0x85,
+     0xc9, 0x4c, 0x99, 0x4f, 0x50, 0x1f, 0xd5, 0xca},
+    {0x00, 0x49, 0xd7, 0xec, 0x89, 0x17, 0x3b, 0xc0,
+     0x65, 0xa5, 0xfb, 0xb2, 0x9e, 0x2c, 0x5e, 0x72},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dsbd[2][16] = {
+    {0x00, 0xa2, 0xb1, 0xe6, 0xdf, 0xcc, 0x57, 0x7d,
+     0x39, 0x44, 0x2a, 0x88, 0x13, 0x9b, 0x6e, 0xf5},
+    {0x00, 0xcb, 0xc6, 0x24, 0xf7, 0xfa, 0xe2, 0x3c,
+     0xd3, 0xef, 0xde, 0x15, 0x0d, 0x18, 0x31, 0x29},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dsbb[2][16] = {
+    {0x00, 0x42, 0xb4, 0x96, 0x92, 0x64, 0x22, 0xd0,
+     0x04, 0xd4, 0xf2, 0xb0, 0xf6, 0x46, 0x26, 0x60},
+    {0x00, 0x67, 0x59, 0xcd, 0xa6, 0x98, 0x94, 0xc1,
+     0x6b, 0xaa, 0x55, 0x32, 0x3e, 0x0c, 0xff, 0xf3},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dsbe[2][16] = {
+    {0x00, 0xd0, 0xd4, 0x26, 0x96, 0x92, 0xf2, 0x46,
+     0xb0, 0xf6, 0xb4, 0x64, 0x04, 0x60, 0x42, 0x22},
+    {0x00, 0xc1, 0xaa, 0xff, 0xcd, 0xa6, 0x55, 0x0c,
+     0x32, 0x3e, 0x59, 0x98, 0x6b, 0xf3, 0x67, 0x94},
+};
+
+static const AES_ALIGN(unsigned char, 16) aes_vperm_dsbo[2][16] = {
+    {0x00, 0x40, 0xf9, 0x7e, 0x53, 0xea, 0x87, 0x13,
+     0x2d, 0x3e, 0x94, 0xd4, 0xb9, 0x6d, 0xaa, 0xc7},
+    {0x00, 0x1d, 0x44, 0x93, 0x0f, 0x56, 0xd7, 0x12,
+     0x9c, 0x8e, 0xc5, 0xd8, 0x59, 0x81, 0x4b, 0xca},
+};
+
+static AES_Block aes_vperm_load(const unsigned char* src) {
+    return _mm_load_si128((const AES_Block*)src);
+}
+
+/* Looks up the low & the high nibbles of each byte in a pair of tables. */
+static AES_Block aes_vperm_transform(AES_Block x, const unsigned char table[2][16]) {
+    const AES_Block s0f = _mm_set1_epi8(0x0f);
+    const AES_Block hi = _mm_srli_epi32(_mm_andnot_si128(s0f, x), 4);
+    const AES_Block lo = _mm_and_si128(x, s0f);
+    return _mm_xor_si128(
+        _mm_shuffle_epi8(aes_vperm_load(table[0]), lo),
+        _mm_shuffle_epi8(aes_vperm_load(table[1]), hi)
+    );
+}
+
+/* Inverts each byte, the results are the indices into the output tables. */
+static void aes_vperm_invert(AES_Block x, AES_Block* io, AES_Block* jo) {
+    const AES_Block s0f = _mm_set1_epi8(0x0f);
+    const AES_Block inv = aes_vperm_load(aes_vperm_inv[0]);
+    const AES_Block i = _mm_srli_epi32(_mm_andnot_si128(s0f, x), 4);
+    const AES_Block k = _mm_and_si128(x, s0f);
+    const AES_Block ak = _mm_shuffle_epi8(aes_vperm_load(aes_vperm_inv[1]), k);
+    const AES_Block j = _mm_xor_si128(k, i);
+    const AES_Block iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);
+    const AES_Block jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);
+    *io = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+    *jo = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+}
+
+/* Looks up the S-box output in a pair of tables. */
+static AES_Block aes_vperm_sbox(AES_Block io, AES_Block jo, const unsigned char table[2][16]) {
+    return _mm_xor_si128(
+        _mm_shuffle_epi8(aes_vperm_load(table[0]), io),
+        _mm_shuffle_epi8(aes_vperm_load(table[1]), jo)
+    );
+}
+
+static AES_Block aes_vperm_encrypt_first(AES_Block x, const AES_Block* keys) {
+    return _mm_xor_si128(aes_vperm_transform(x, aes_vperm_ipt), keys[0]);
+}
+
+static AES_Block aes_vperm_encrypt_round(AES_Block x, const AES_Block* keys, int round) {
+    const AES_Block forward = aes_vperm_load(aes_vperm_mc_forward[round % 4]);
+    const AES_Block backward = aes_vperm_load(aes_vperm_mc_backward[round % 4]);
+    AES_Block io, jo;
+
+    aes_vperm_invert(x, &io, &jo);
+    const AES_Block a = _mm_xor_si128(aes_vperm_sbox(io, jo, aes_vperm_sb1), keys[round]);
+    const AES_Block a2 = aes_vperm_sbox(io, jo, aes_vperm_sb2);
+    const AES_Block a2b = _mm_xor_si128(_mm_shuffle_epi8(a, forward), a2);
+    const AES_Block a2bd = _mm_xor_si128(_mm_shuffle_epi8(a, backward), a2b);
+    return _mm_xor_si128(_mm_shuffle_epi8(a2b, forward), a2bd);
+}
+
+static AES_Block aes_vperm_encrypt_last(AES_Block x, const AES_Block* keys, int numof_rounds) {
+    AES_Block io, jo;
+
+    aes_vperm_invert(x, &io, &jo);
+    x = _mm_xor_si128(aes_vperm_sbox(io, jo, aes_vperm_sbo), keys[numof_rounds]);
+    return _mm_shuffle_epi8(x, aes_vperm_load(aes_vperm_sr[numof_rounds % 4]));
+}
+
+static AES_Block aes_vperm_decrypt_first(AES_Block x, const AES_Block* keys) {
+    return _mm_xor_si128(aes_vperm_transform(x, aes_vperm_dipt), keys[0]);
+}
+
+/* The column rotation for round i is mc_forward[3] rotated i-1 times. */
+static AES_Block aes_vperm_decrypt_round(AES_Block x, const AES_Block* keys, int round) {
+    const AES_Block mc = aes_vperm_load(aes_vperm_mc_forward[(4 - round % 4) % 4]);
+    AES_Block io, jo;
+
+    aes_vperm_invert(x, &io, &jo);
+    x = _mm_xor_si128(keys[round], aes_vperm_sbox(io, jo, aes_vperm_dsb9));
+    x = _mm_shuffle_epi8(x, mc);
+    x = _mm_xor_si128(x, aes_vperm_sbox(io, jo, aes_vperm_dsbd));
+    x = _mm_shuffle_epi8(x, mc);
+    x = _mm_xor_si128(x, aes_vperm_sbox(io, jo, aes_vperm_dsbb));
+    x = _mm_shuffle_epi8(x, mc);
+    return _mm_xor_si128(x, aes_vperm_sbox(io, jo, aes_vperm_dsbe));
+}
+
+static AES_Block aes_vperm_decrypt_last(AES_Block x, const AES_Block* keys, int numof_rounds) {
+    AES_Block io, jo;
+
+    aes_vperm_invert(x, &io, &jo);
+    x = _mm_xor_si128(aes_vperm_sbox(io, jo, aes_vperm_dsbo), keys[numof_rounds]);
+    return _mm_shuffle_epi8(x, aes_vperm_load(aes_vperm_sr[((numof_rounds - 1) % 4) ^ 3]));
+}
+
+/* The instructions in a round mostly depend on each other, so several blocks
+ * are processed in lockstep to keep the CPU busy. */
+
+static void aes_vperm_encrypt_blocks4(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = aes_vperm_encrypt_first(aes_load_block(&plaintext[0]), keys);
+    AES_Block b1 = aes_vperm_encrypt_first(aes_load_block(&plaintext[1]), keys);
+    AES_Block b2 = aes_vperm_encrypt_first(aes_load_block(&plaintext[2]), keys);
+    AES_Block b3 = aes_vperm_encrypt_first(aes_load_block(&plaintext[3]), keys);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        b0 = aes_vperm_encrypt_round(b0, keys, i);
+        b1 = aes_vperm_encrypt_round(b1, keys, i);
+        b2 = aes_vperm_encrypt_round(b2, keys, i);
+        b3 = aes_vperm_encrypt_round(b3, keys, i);
+    }
+
+    aes_store_block(&ciphertext[0], aes_vperm_encrypt_last(b0, keys, numof_rounds));
+    aes_store_block(&ciphertext[1], aes_vperm_encrypt_last(b1, keys, numof_rounds));
+    aes_store_block(&ciphertext[2], aes_vperm_encrypt_last(b2, keys, numof_rounds));
+    aes_store_block(&ciphertext[3], aes_vperm_encrypt_last(b3, keys, numof_rounds));
+}
+
+static void aes_vperm_encrypt_blocks2(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = aes_vperm_encrypt_first(aes_load_block(&plaintext[0]), keys);
+    AES_Block b1 = aes_vperm_encrypt_first(aes_load_block(&plaintext[1]), keys);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        b0 = aes_vperm_encrypt_round(b0, keys, i);
+        b1 = aes_vperm_encrypt_round(b1, keys, i);
+    }
+
+    aes_store_block(&ciphertext[0], aes_vperm_encrypt_last(b0, keys, numof_rounds));
+    aes_store_block(&ciphertext[1], aes_vperm_encrypt_last(b1, keys, numof_rounds));
+}
+
+static AES_Block aes_vperm_encrypt_block(AES_Block b0, const AES_Block* keys, int numof_rounds) {
+    b0 = aes_vperm_encrypt_first(b0, keys);
+    for (int i = 1; i < numof_rounds; ++i)
+        b0 = aes_vperm_encrypt_round(b0, keys, i);
+    return aes_vperm_encrypt_last(b0, keys, numof_rounds);
+}
+
+static void aes_vperm_encrypt_blocks(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    for (; numof_blocks >= 4; numof_blocks -= 4, plaintext += 4, ciphertext += 4)
+        aes_vperm_encrypt_blocks4(plaintext, ciphertext, keys, numof_rounds);
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        const AES_Block block = aes_load_block(plaintext);
+        aes_store_block(ciphertext, aes_vperm_encrypt_block(block, keys, numof_rounds));
+    }
+}
+
+static void aes_vperm_decrypt_blocks4(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block b0 = aes_vperm_decrypt_first(aes_load_block(&ciphertext[0]), keys);
+    AES_Block b1 = aes_vperm_decrypt_first(aes_load_block(&ciphertext[1]), keys);
+    AES_Block b2 = aes_vperm_decrypt_first(aes_load_block(&ciphertext[2]), keys);
+    AES_Block b3 = aes_vperm_decrypt_first(aes_load_block(&ciphertext[3]), keys);
+
+    for (int i = 1; i < numof_rounds; ++i) {
+        b0 = aes_vperm_decrypt_round(b0, keys, i);
+        b1 = aes_vperm_decrypt_round(b1, keys, i);
+        b2 = aes_vperm_decrypt_round(b2, keys, i);
+        b3 = aes_vperm_decrypt_round(b3, keys, i);
+    }
+
+    aes_store_block(&plaintext[0], aes_vperm_decrypt_last(b0, keys, numof_rounds));
+    aes_store_block(&plaintext[1], aes_vperm_decrypt_last(b1, keys, numof_rounds));
+    aes_store_block(&plaintext[2], aes_vperm_decrypt_last(b2, keys, numof_rounds));
+    aes_store_block(&plaintext[3], aes_vperm_decrypt_last(b3, keys, numof_rounds));
+}
+
+static AES_Block aes_vperm_decrypt_block(AES_Block b0, const AES_Block* keys, int numof_rounds) {
+    b0 = aes_vperm_decrypt_first(b0, keys);
+    for (int i = 1; i < numof_rounds; ++i)
+        b0 = aes_vperm_decrypt_round(b0, keys, i);
+    return aes_vperm_decrypt_last(b0, keys, numof_rounds);
+}
+
+static void aes_vperm_decrypt_blocks(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    for (; numof_blocks >= 4; numof_blocks -= 4, ciphertext += 4, plaintext += 4)
+        aes_vperm_decrypt_blocks4(ciphertext, plaintext, keys, numof_rounds);
+
+    for (; numof_blocks > 0; --numof_blocks, ++ciphertext, ++plaintext) {
+        const AES_Block block = aes_load_block(ciphertext);
+        aes_store_block(plaintext, aes_vperm_decrypt_block(block, keys, numof_rounds));
+    }
+}
+
+static void aes_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block chain = *iv;
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        const AES_Block block = aes_xor_blocks(aes_load_block(plaintext), chain);
+        chain = aes_vperm_encrypt_block(block, keys, numof_rounds);
+        aes_store_block(ciphertext, chain);
+    }
+
+    *iv = chain;
+}
+
+static void aes_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block chain = *iv;
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        const AES_Block keystream = aes_vperm_encrypt_block(chain, keys, numof_rounds);
+        chain = aes_xor_blocks(keystream, aes_load_block(plaintext));
+        aes_store_block(ciphertext, chain);
+    }
+
+    *iv = chain;
+}
+
+static void aes_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES_Block* keys,
+    int numof_rounds
+) {
+    AES_Block chain = *iv;
+
+    for (; numof_blocks > 0; --numof_blocks, ++plaintext, ++ciphertext) {
+        chain = aes_vperm_encrypt_block(chain, keys, numof_rounds);
+        aes_store_block(ciphertext, aes_xor_blocks(chain, aes_load_block(plaintext)));
+    }
+
+    *iv = chain;
+}
+
+/* The key schedule is computed in the internal basis as well.
+ * The decryption keys are stored in the reverse order. */
+
+typedef struct {
+    AES_Block* dest;
+    int sr;
+    int decrypt;
+} AES_VpermSchedule;
+
+static AES_Block aes_vperm_schedule_low_round(AES_Block x, AES_Block prev) {
+    AES_Block io, jo;
+
+    prev = _mm_xor_si128(prev, _mm_slli_si128(prev, 4));
+    prev = _mm_xor_si128(prev, _mm_slli_si128(prev, 8));
+    prev = _mm_xor_si128(prev, _mm_set1_epi8(0x5b));
+
+    aes_vperm_invert(x, &io, &jo);
+    return _mm_xor_si128(aes_vperm_sbox(io, jo, aes_vperm_sb1), prev);
+}
+
+static AES_Block aes_vperm_schedule_round(AES_Block x, AES_Block prev, AES_Block* rcon) {
+    prev = _mm_xor_si128(prev, _mm_alignr_epi8(_mm_setzero_si128(), *rcon, 15));
+    *rcon = _mm_alignr_epi8(*rcon, *rcon, 15);
+
+    x = _mm_shuffle_epi32(x, 0xff);
+    x = _mm_alignr_epi8(x, x, 1);
+    return aes_vperm_schedule_low_round(x, prev);
+}
+
+static AES_Block aes_vperm_schedule_192_smear(AES_Block* hi, AES_Block prev) {
+    AES_Block x = _mm_xor_si128(*hi, _mm_shuffle_epi32(*hi, 0x80));
+    x = _mm_xor_si128(x, _mm_shuffle_epi32(prev, 0xfe));
+    *hi = _mm_unpackhi_epi64(_mm_setzero_si128(), x);
+    return x;
+}
+
+static void aes_vperm_schedule_mangle(AES_VpermSchedule* schedule, AES_Block x) {
+    const AES_Block forward = aes_vperm_load(aes_vperm_mc_forward[0]);
+    AES_Block key;
+
+    if (schedule->decrypt) {
+        const AES_Block s0f = _mm_set1_epi8(0x0f);
+        const AES_Block hi = _mm_srli_epi32(_mm_andnot_si128(s0f, x), 4);
+        const AES_Block lo = _mm_and_si128(x, s0f);
+        key = aes_vperm_sbox(lo, hi, aes_vperm_dksd);
+        key = _mm_shuffle_epi8(key, forward);
+        key = _mm_xor_si128(key, aes_vperm_sbox(lo, hi, aes_vperm_dksb));
+        key = _mm_shuffle_epi8(key, forward);
+        key = _mm_xor_si128(key, aes_vperm_sbox(lo, hi, aes_vperm_dkse));
+        key = _mm_shuffle_epi8(key, forward);
+        key = _mm_xor_si128(key, aes_vperm_sbox(lo, hi, aes_vperm_dks9));
+        --schedule->dest;
+    } else {
+        x = _mm_shuffle_epi8(_mm_xor_si128(x, _mm_set1_epi8(0x5b)), forward);
+        key = x;
+        x = _mm_shuffle_epi8(x, forward);
+        key = _mm_xor_si128(key, x);
+        x = _mm_shuffle_epi8(x, forward);
+        key = _mm_xor_si128(key, x);
+        ++schedule->dest;
+    }
+
+    *schedule->dest = _mm_shuffle_epi8(key, aes_vperm_load(aes_vperm_sr[schedule->sr]));
+    schedule->sr = (schedule->sr + 3) % 4;
+}
+
+static void aes_vperm_schedule_mangle_last(AES_VpermSchedule* schedule, AES_Block x) {
+    if (schedule->decrypt) {
+        x = _mm_xor_si128(x, _mm_set1_epi8(0x5b));
+        x = aes_vperm_transform(x, aes_vperm_deskew);
+        --schedule->dest;
+    } else {
+        x = _mm_shuffle_epi8(x, aes_vperm_load(aes_vperm_sr[schedule->sr]));
+        x = _mm_xor_si128(x, _mm_set1_epi8(0x5b));
+        x = aes_vperm_transform(x, aes_vperm_opt);
+        ++schedule->dest;
+    }
+
+    *schedule->dest = x;
+}
+
+static void aes_vperm_expand_key(
+    const unsigned char* key,
+    int key_len,
+    AES_Block* keys,
+    int numof_rounds,
+    int decrypt
+) {
+    AES_VpermSchedule schedule;
+    AES_Block rcon = aes_vperm_load(aes_vperm_rcon);
+    AES_Block x, prev, hi;
+
+    schedule.decrypt = decrypt;
+
+    x = _mm_loadu_si128((const AES_Block*)key);
+    prev = aes_vperm_transform(x, aes_vperm_ipt);
+
+    if (decrypt) {
+        schedule.dest = keys + numof_rounds;
+        schedule.sr = key_len == 24 ? 0 : 2;
+        *schedule.dest = _mm_shuffle_epi8(x, aes_vperm_load(aes_vperm_sr[schedule.sr]));
+        schedule.sr ^= 3;
+    } else {
+        schedule.dest = keys;
+        schedule.sr = 3;
+        *schedule.dest = prev;
+    }
+
+    x = prev;
+
+    switch (key_len) {
+        case 16:
+            for (int i = 1;; ++i) {
+                x = prev = aes_vperm_schedule_round(x, prev, &rcon);
+                if (i == 10)
+                    break;
+                aes_vperm_schedule_mangle(&schedule, x);
+            }
+            break;
+
+        case 24:
+            x = aes_vperm_transform(_mm_loadu_si128((const AES_Block*)(key + 8)), aes_vperm_ipt);
+            hi = _mm_unpackhi_epi64(_mm_setzero_si128(), x);
+            for (int i = 1;; ++i) {
+                x = prev = aes_vperm_schedule_round(x, prev, &rcon);
+                aes_vperm_schedule_mangle(&schedule, _mm_alignr_epi8(x, hi, 8));
+                x = aes_vperm_schedule_192_smear(&hi, prev);
+                aes_vperm_schedule_mangle(&schedule, x);
+                x = prev = aes_vperm_schedule_round(x, prev, &rcon);
+                if (i == 4)
+                    break;
+                aes_vperm_schedule_mangle(&schedule, x);
+                x = aes_vperm_schedule_192_smear(&hi, prev);
+            }
+            break;
+
+        case 32:
+            x = aes_vperm_transform(_mm_loadu_si128((const AES_Block*)(key + 16)), aes_vperm_ipt);
+            for (int i = 1;; ++i) {
+                aes_vperm_schedule_mangle(&schedule, x);
+                hi = x;
+                x = prev = aes_vperm_schedule_round(x, prev, &rcon);
+                if (i == 7)
+                    break;
+                aes_vperm_schedule_mangle(&schedule, x);
+                x = aes_vperm_schedule_low_round(_mm_shuffle_epi32(x, 0xff), hi);
+            }
+            break;
+    }
+
+    aes_vperm_schedule_mangle_last(&schedule, x);
+}
+
+AES_Block
+aes128_encrypt_block_vperm(AES_Block plaintext, const AES128_RoundKeys* encryption_keys) {
+    return aes_vperm_encrypt_block(plaintext, encryption_keys->keys, 10);
+}
+
+AES_Block
+aes128_decrypt_block_vperm(AES_Block ciphertext, const AES128_RoundKeys* decryption_keys) {
+    return aes_vperm_decrypt_block(ciphertext, decryption_keys->keys, 10);
+}
+
+void aes128_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 10);
+}
+
+void aes128_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES128_RoundKeys* decryption_keys
+) {
+    aes_vperm_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 10);
+}
+
+void aes128_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 10);
+}
+
+void aes128_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void aes128_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void aes128_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES128_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 10);
+}
+
+void aes128_expand_key_vperm(
+    AES_Block key,
+    AES128_RoundKeys* encryption_keys,
+    AES128_RoundKeys* decryption_keys
+) {
+    AES_ALIGN(unsigned char, 16) bytes[16];
+    aes_store_block_aligned(bytes, key);
+    aes_vperm_expand_key(bytes, 16, encryption_keys->keys, 10, 0);
+    if (decryption_keys != NULL)
+        aes_vperm_expand_key(bytes, 16, decryption_keys->keys, 10, 1);
+}
+
+AES_Block
+aes192_encrypt_block_vperm(AES_Block plaintext, const AES192_RoundKeys* encryption_keys) {
+    return aes_vperm_encrypt_block(plaintext, encryption_keys->keys, 12);
+}
+
+AES_Block
+aes192_decrypt_block_vperm(AES_Block ciphertext, const AES192_RoundKeys* decryption_keys) {
+    return aes_vperm_decrypt_block(ciphertext, decryption_keys->keys, 12);
+}
+
+void aes192_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 12);
+}
+
+void aes192_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES192_RoundKeys* decryption_keys
+) {
+    aes_vperm_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 12);
+}
+
+void aes192_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 12);
+}
+
+void aes192_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void aes192_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void aes192_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES192_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 12);
+}
+
+void aes192_expand_key_vperm(
+    AES_Block key_lo,
+    AES_Block key_hi,
+    AES192_RoundKeys* encryption_keys,
+    AES192_RoundKeys* decryption_keys
+) {
+    AES_ALIGN(unsigned char, 16) bytes[32];
+    aes_store_block_aligned(bytes, key_lo);
+    aes_store_block_aligned(bytes + 16, key_hi);
+    aes_vperm_expand_key(bytes, 24, encryption_keys->keys, 12, 0);
+    if (decryption_keys != NULL)
+        aes_vperm_expand_key(bytes, 24, decryption_keys->keys, 12, 1);
+}
+
+AES_Block
+aes256_encrypt_block_vperm(AES_Block plaintext, const AES256_RoundKeys* encryption_keys) {
+    return aes_vperm_encrypt_block(plaintext, encryption_keys->keys, 14);
+}
+
+AES_Block
+aes256_decrypt_block_vperm(AES_Block ciphertext, const AES256_RoundKeys* decryption_keys) {
+    return aes_vperm_decrypt_block(ciphertext, decryption_keys->keys, 14);
+}
+
+void aes256_encrypt_blocks_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks(plaintext, ciphertext, numof_blocks, encryption_keys->keys, 14);
+}
+
+void aes256_decrypt_blocks_vperm(
+    const AES_Block* ciphertext,
+    AES_Block* plaintext,
+    size_t numof_blocks,
+    const AES256_RoundKeys* decryption_keys
+) {
+    aes_vperm_decrypt_blocks(ciphertext, plaintext, numof_blocks, decryption_keys->keys, 14);
+}
+
+void aes256_encrypt_pair_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_vperm_encrypt_blocks2(plaintext, ciphertext, encryption_keys->keys, 14);
+}
+
+void aes256_encrypt_cbc_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cbc_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
+
+void aes256_encrypt_cfb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_cfb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
+
+void aes256_encrypt_ofb_vperm(
+    const AES_Block* plaintext,
+    AES_Block* ciphertext,
+    size_t numof_blocks,
+    AES_Block* iv,
+    const AES256_RoundKeys* encryption_keys
+) {
+    aes_encrypt_ofb_vperm(plaintext, ciphertext, numof_blocks, iv, encryption_keys->keys, 14);
+}
+
+void aes256_expand_key_vperm(
+    AES_Block key_lo,
+    AES_Block key_hi,
+    AES256_RoundKeys* encryption_keys,
+    AES256_RoundKeys* decryption_keys
+) {
+    AES_ALIGN(unsigned char, 16) bytes[32];
+    aes_store_block_aligned(bytes, key_lo);
+    aes_store_block_aligned(bytes + 16, key_hi);
+    aes_vperm_expand_key(bytes, 32, encryption_keys->keys, 14, 0);
+    if (decryption_keys != NULL)
+        aes_vperm_expand_key(bytes, 32, decryption_keys->keys, 14, 1);
+}
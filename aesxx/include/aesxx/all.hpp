@@ -6,8 +6,13 @@
 #pragma once
 
 #include "algorithm.hpp"
+#include "basic_box.hpp"
 #include "block.hpp"
 #include "box.hpp"
+#include "buffer.hpp"
+#include "cmac.hpp"
 #include "debug.hpp"
+#include "drbg.hpp"
 #include "error.hpp"
+#include "kw.hpp"
 #include "mode.hpp"
@@ -0,0 +1,411 @@
+// Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+// This file is part of the "AES tools" project.
+// For details, see https://github.com/egor-tensin/aes-tools.
+// Distributed under the MIT License.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "block.hpp"
+#include "error.hpp"
+#include "key.hpp"
+#include "mode.hpp"
+
+#include <aes/all.h>
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace aes {
+
+// The AES-NI kernels for an algorithm (see aes/aes.h & aes/round_keys.h).
+template <Algorithm algorithm>
+struct Kernels;
+
+template <>
+struct Kernels<AES_AES128> {
+    using RoundKeys = AES128_RoundKeys;
+
+    static void expand_key(const AES_Key& key, RoundKeys& encryption_keys) {
+        aes128_expand_key_internal(key.aes128_key.key, &encryption_keys);
+    }
+
+    static void derive_decryption_keys(
+        const RoundKeys& encryption_keys,
+        RoundKeys& decryption_keys
+    ) {
+        aes128_derive_decryption_keys_internal(&encryption_keys, &decryption_keys);
+    }
+
+    static AES_Block encrypt_block(AES_Block plaintext, const RoundKeys& keys) {
+        return aes128_encrypt_block_internal(plaintext, &keys);
+    }
+
+    static void encrypt_blocks(
+        const AES_Block* plaintext,
+        AES_Block* ciphertext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes128_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, &keys);
+    }
+
+    static void decrypt_blocks(
+        const AES_Block* ciphertext,
+        AES_Block* plaintext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes128_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, &keys);
+    }
+};
+
+template <>
+struct Kernels<AES_AES192> {
+    using RoundKeys = AES192_RoundKeys;
+
+    static void expand_key(const AES_Key& key, RoundKeys& encryption_keys) {
+        aes192_expand_key_internal(key.aes192_key.lo, key.aes192_key.hi, &encryption_keys);
+    }
+
+    static void derive_decryption_keys(
+        const RoundKeys& encryption_keys,
+        RoundKeys& decryption_keys
+    ) {
+        aes192_derive_decryption_keys_internal(&encryption_keys, &decryption_keys);
+    }
+
+    static AES_Block encrypt_block(AES_Block plaintext, const RoundKeys& keys) {
+        return aes192_encrypt_block_internal(plaintext, &keys);
+    }
+
+    static void encrypt_blocks(
+        const AES_Block* plaintext,
+        AES_Block* ciphertext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes192_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, &keys);
+    }
+
+    static void decrypt_blocks(
+        const AES_Block* ciphertext,
+        AES_Block* plaintext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes192_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, &keys);
+    }
+};
+
+template <>
+struct Kernels<AES_AES256> {
+    using RoundKeys = AES256_RoundKeys;
+
+    static void expand_key(const AES_Key& key, RoundKeys& encryption_keys) {
+        aes256_expand_key_internal(key.aes256_key.lo, key.aes256_key.hi, &encryption_keys);
+    }
+
+    static void derive_decryption_keys(
+        const RoundKeys& encryption_keys,
+        RoundKeys& decryption_keys
+    ) {
+        aes256_derive_decryption_keys_internal(&encryption_keys, &decryption_keys);
+    }
+
+    static AES_Block encrypt_block(AES_Block plaintext, const RoundKeys& keys) {
+        return aes256_encrypt_block_internal(plaintext, &keys);
+    }
+
+    static void encrypt_blocks(
+        const AES_Block* plaintext,
+        AES_Block* ciphertext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes256_encrypt_blocks_internal(plaintext, ciphertext, numof_blocks, &keys);
+    }
+
+    static void decrypt_blocks(
+        const AES_Block* ciphertext,
+        AES_Block* plaintext,
+        std::size_t numof_blocks,
+        const RoundKeys& keys
+    ) {
+        aes256_decrypt_blocks_internal(ciphertext, plaintext, numof_blocks, &keys);
+    }
+};
+
+// Box with the algorithm & the mode fixed at compile time.
+// It calls the AES-NI kernels directly instead of going through AES_Ops & the mode tables in
+// box.c, so check aes_is_impl_supported(AES_IMPL_AESNI) first.
+// Only ECB, CBC, CFB, OFB & CTR are supported, use Box for the other modes.
+// The results are the same as Box's, src & dest can point to the same buffer.
+template <Algorithm algorithm, Mode mode>
+class BasicBox {
+    static_assert(
+        mode == AES_ECB || mode == AES_CBC || mode == AES_CFB || mode == AES_OFB || mode == AES_CTR,
+        "BasicBox only supports ECB, CBC, CFB, OFB & CTR modes, use Box instead"
+    );
+
+public:
+    explicit BasicBox(const Key& key)
+        requires(mode == AES_ECB)
+    {
+        expand_key(key);
+    }
+
+    BasicBox(const Key& key, const Block& iv)
+        requires(mode != AES_ECB)
+        : iv{*iv.ptr()} {
+        expand_key(key);
+    }
+
+    void set_iv(const Block& iv)
+        requires(mode != AES_ECB)
+    {
+        this->iv = *iv.ptr();
+    }
+
+    // numof_blocks complete blocks, the IV is updated to continue where they end.
+
+    void encrypt_blocks(const void* src_buf, std::size_t numof_blocks, void* dest_buf) {
+        const auto* src = static_cast<const unsigned char*>(src_buf);
+        auto* dest = static_cast<unsigned char*>(dest_buf);
+
+        if constexpr (mode == AES_ECB) {
+            K::encrypt_blocks(as_blocks(src), as_blocks(dest), numof_blocks, encryption_keys);
+        } else if constexpr (mode == AES_CBC) {
+            for (std::size_t i = 0; i < numof_blocks; ++i) {
+                iv = K::encrypt_block(aes_xor_blocks(aes_load_block(src), iv), encryption_keys);
+                aes_store_block(dest, iv);
+                src += block_size;
+                dest += block_size;
+            }
+        } else if constexpr (mode == AES_CFB) {
+            for (std::size_t i = 0; i < numof_blocks; ++i) {
+                iv = aes_xor_blocks(K::encrypt_block(iv, encryption_keys), aes_load_block(src));
+                aes_store_block(dest, iv);
+                src += block_size;
+                dest += block_size;
+            }
+        } else {
+            apply_keystream(src, numof_blocks, dest);
+        }
+    }
+
+    void decrypt_blocks(const void* src_buf, std::size_t numof_blocks, void* dest_buf) {
+        const auto* src = static_cast<const unsigned char*>(src_buf);
+        auto* dest = static_cast<unsigned char*>(dest_buf);
+
+        if constexpr (mode == AES_ECB) {
+            K::decrypt_blocks(as_blocks(src), as_blocks(dest), numof_blocks, decryption_keys);
+        } else if constexpr (mode == AES_CBC) {
+            AES_Block output[batch_len];
+
+            while (numof_blocks > 0) {
+                const std::size_t n = numof_blocks < batch_len ? numof_blocks : batch_len;
+
+                K::decrypt_blocks(as_blocks(src), output, n, decryption_keys);
+
+                // Load each ciphertext block before it's overwritten.
+                for (std::size_t i = 0; i < n; ++i) {
+                    const AES_Block input = aes_load_block(src + i * block_size);
+                    aes_store_block(dest + i * block_size, aes_xor_blocks(output[i], iv));
+                    iv = input;
+                }
+
+                src += n * block_size;
+                dest += n * block_size;
+                numof_blocks -= n;
+            }
+        } else if constexpr (mode == AES_CFB) {
+            AES_Block keystream[batch_len];
+
+            // The keystream is E(C[i-1]), so every block of a batch is encrypted at once.
+            while (numof_blocks > 0) {
+                const std::size_t n = numof_blocks < batch_len ? numof_blocks : batch_len;
+
+                keystream[0] = iv;
+                for (std::size_t i = 1; i < n; ++i)
+                    keystream[i] = aes_load_block(src + (i - 1) * block_size);
+                iv = aes_load_block(src + (n - 1) * block_size);
+
+                K::encrypt_blocks(keystream, keystream, n, encryption_keys);
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    const AES_Block input = aes_load_block(src + i * block_size);
+                    aes_store_block(dest + i * block_size, aes_xor_blocks(keystream[i], input));
+                }
+
+                src += n * block_size;
+                dest += n * block_size;
+                numof_blocks -= n;
+            }
+        } else {
+            apply_keystream(src, numof_blocks, dest);
+        }
+    }
+
+    // In ECB & CBC modes, the message is padded (see aes_box_encrypted_size).
+
+    static constexpr std::size_t encrypted_size(std::size_t src_size) {
+        if constexpr (is_padded)
+            return src_size + block_size - src_size % block_size;
+        else
+            return src_size;
+    }
+
+    static constexpr std::size_t max_decrypted_size(std::size_t src_size) {
+        return src_size;
+    }
+
+    // dest must be large enough to hold the result, see encrypted_size & max_decrypted_size.
+    // These return the number of bytes written.
+
+    std::size_t encrypt_buffer(std::span<const std::byte> src, std::span<std::byte> dest) {
+        const std::size_t dest_size = encrypted_size(src.size());
+        if (dest.size() < dest_size)
+            aes_error_buffer_too_small(ErrorDetailsThrowsInDestructor{});
+
+        const std::size_t numof_blocks = src.size() / block_size;
+        const std::size_t tail_size = src.size() % block_size;
+
+        encrypt_blocks(src.data(), numof_blocks, dest.data());
+
+        if constexpr (is_padded) {
+            AES_ALIGN(unsigned char, 16) block[16];
+            std::memcpy(block, src.data() + numof_blocks * block_size, tail_size);
+            aes_fill_with_padding(
+                AES_PADDING_PKCS7,
+                block + tail_size,
+                block_size - tail_size,
+                ErrorDetailsThrowsInDestructor{}
+            );
+
+            encrypt_blocks(block, 1, dest.data() + numof_blocks * block_size);
+        } else if (tail_size != 0) {
+            AES_ALIGN(unsigned char, 16) block[16] = {};
+            std::memcpy(block, src.data() + numof_blocks * block_size, tail_size);
+            encrypt_blocks(block, 1, block);
+            std::memcpy(dest.data() + numof_blocks * block_size, block, tail_size);
+        }
+
+        return dest_size;
+    }
+
+    std::size_t decrypt_buffer(std::span<const std::byte> src, std::span<std::byte> dest) {
+        std::size_t dest_size = max_decrypted_size(src.size());
+        if (dest.size() < dest_size)
+            aes_error_buffer_too_small(ErrorDetailsThrowsInDestructor{});
+
+        const std::size_t numof_blocks = src.size() / block_size;
+        const std::size_t tail_size = src.size() % block_size;
+
+        if constexpr (is_padded) {
+            if (src.empty() || tail_size != 0)
+                aes_error_missing_padding(ErrorDetailsThrowsInDestructor{});
+
+            decrypt_blocks(src.data(), numof_blocks, dest.data());
+
+            std::size_t padding_size = 0;
+            aes_extract_padding_size(
+                AES_PADDING_PKCS7,
+                dest.data() + dest_size - block_size,
+                block_size,
+                &padding_size,
+                ErrorDetailsThrowsInDestructor{}
+            );
+
+            dest_size -= padding_size;
+        } else {
+            decrypt_blocks(src.data(), numof_blocks, dest.data());
+
+            if (tail_size != 0) {
+                AES_ALIGN(unsigned char, 16) block[16] = {};
+                std::memcpy(block, src.data() + numof_blocks * block_size, tail_size);
+                decrypt_blocks(block, 1, block);
+                std::memcpy(dest.data() + numof_blocks * block_size, block, tail_size);
+            }
+        }
+
+        return dest_size;
+    }
+
+private:
+    using K = Kernels<algorithm>;
+    using RoundKeys = typename K::RoundKeys;
+
+    static constexpr std::size_t block_size = sizeof(AES_Block);
+    // The same as in box.c.
+    static constexpr std::size_t batch_len = 32;
+
+    static constexpr bool is_padded = mode == AES_ECB || mode == AES_CBC;
+    // The other modes only use the block cipher in the forward direction.
+    static constexpr bool needs_decryption_keys = is_padded;
+
+    struct NoRoundKeys {};
+
+    static const AES_Block* as_blocks(const void* buf) {
+        return static_cast<const AES_Block*>(buf);
+    }
+
+    static AES_Block* as_blocks(void* buf) {
+        return static_cast<AES_Block*>(buf);
+    }
+
+    void expand_key(const Key& key) {
+        K::expand_key(*key.ptr(), encryption_keys);
+        if constexpr (needs_decryption_keys)
+            K::derive_decryption_keys(encryption_keys, decryption_keys);
+    }
+
+    // OFB & CTR, decryption is the same as encryption.
+    void apply_keystream(const unsigned char* src, std::size_t numof_blocks, unsigned char* dest) {
+        if constexpr (mode == AES_OFB) {
+            for (std::size_t i = 0; i < numof_blocks; ++i) {
+                iv = K::encrypt_block(iv, encryption_keys);
+                aes_store_block(dest, aes_xor_blocks(iv, aes_load_block(src)));
+                src += block_size;
+                dest += block_size;
+            }
+        } else {
+            AES_Block keystream[batch_len];
+
+            // The counter is kept with its bytes reversed, see aes_box_encrypt_blocks_ctr.
+            const AES_Block one = aes_make_block(0, 0, 0, 1);
+            AES_Block counter = aes_reverse_byte_order(iv);
+
+            while (numof_blocks > 0) {
+                const std::size_t n = numof_blocks < batch_len ? numof_blocks : batch_len;
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    keystream[i] = aes_reverse_byte_order(counter);
+                    counter = _mm_add_epi32(counter, one);
+                }
+
+                K::encrypt_blocks(keystream, keystream, n, encryption_keys);
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    const AES_Block input = aes_load_block(src + i * block_size);
+                    aes_store_block(dest + i * block_size, aes_xor_blocks(keystream[i], input));
+                }
+
+                src += n * block_size;
+                dest += n * block_size;
+                numof_blocks -= n;
+            }
+
+            iv = aes_reverse_byte_order(counter);
+        }
+    }
+
+    RoundKeys encryption_keys;
+    [[no_unique_address]] std::conditional_t<needs_decryption_keys, RoundKeys, NoRoundKeys>
+        decryption_keys;
+    AES_Block iv = _mm_setzero_si128();
+};
+
+} // namespace aes
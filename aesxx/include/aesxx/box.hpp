@@ -7,14 +7,18 @@
 
 #include "algorithm.hpp"
 #include "block.hpp"
+#include "buffer.hpp"
 #include "error.hpp"
 #include "key.hpp"
 #include "mode.hpp"
 
 #include <aes/all.h>
 
+#include <array>
 #include <cstddef>
 #include <iostream>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -40,6 +44,45 @@ public:
         dump_key(key);
     }
 
+    // XTS mode.
+    Box(Algorithm algorithm,
+        const Key& key,
+        const Key& tweak_key,
+        const std::optional<Block>& iv,
+        bool verbose = false)
+        : verbose{verbose} {
+        aes_box_init_xts(
+            &impl,
+            algorithm,
+            key.ptr(),
+            tweak_key.ptr(),
+            iv ? iv->ptr() : NULL,
+            ErrorDetailsThrowsInDestructor{}
+        );
+        dump_key(key);
+        dump_key(tweak_key);
+    }
+
+    // CCM mode with non-default nonce & tag sizes.
+    Box(Algorithm algorithm,
+        const Key& key,
+        const Block& iv,
+        std::size_t nonce_size,
+        std::size_t tag_size,
+        bool verbose = false)
+        : verbose{verbose} {
+        aes_box_init_ccm(
+            &impl,
+            algorithm,
+            key.ptr(),
+            iv.ptr(),
+            nonce_size,
+            tag_size,
+            ErrorDetailsThrowsInDestructor{}
+        );
+        dump_key(key);
+    }
+
     Algorithm get_algorithm() const {
         return impl.algorithm;
     }
@@ -51,68 +94,325 @@ public:
     void encrypt_block(const Block& plaintext, Block& ciphertext) {
         dump_iv();
         dump_plaintext(plaintext);
-        aes_box_encrypt_block(
-            &impl, plaintext.ptr(), ciphertext.ptr(), ErrorDetailsThrowsInDestructor{}
-        );
+        call_with_lazy_error_details([&](AES_ErrorDetails* err_details) {
+            return aes_box_encrypt_block(&impl, plaintext.ptr(), ciphertext.ptr(), err_details);
+        });
         dump_ciphertext(ciphertext);
     }
 
     void decrypt_block(const Block& ciphertext, Block& plaintext) {
         dump_iv();
         dump_ciphertext(ciphertext);
-        aes_box_decrypt_block(
-            &impl, ciphertext.ptr(), plaintext.ptr(), ErrorDetailsThrowsInDestructor{}
-        );
+        call_with_lazy_error_details([&](AES_ErrorDetails* err_details) {
+            return aes_box_decrypt_block(&impl, ciphertext.ptr(), plaintext.ptr(), err_details);
+        });
         dump_plaintext(plaintext);
     }
 
-    std::vector<unsigned char> encrypt_buffer(const void* src_buf, std::size_t src_size) {
+    // Without any checks, the mode mustn't be an authenticated one (see
+    // aes_box_encrypt_block_unchecked).
+
+    void encrypt_block_unchecked(const Block& plaintext, Block& ciphertext) {
+        aes_box_encrypt_block_unchecked(&impl, plaintext.ptr(), ciphertext.ptr());
+    }
+
+    void decrypt_block_unchecked(const Block& ciphertext, Block& plaintext) {
+        aes_box_decrypt_block_unchecked(&impl, ciphertext.ptr(), plaintext.ptr());
+    }
+
+    std::size_t encrypted_size(std::size_t src_size) const {
         std::size_t dest_size = 0;
+        aes_box_encrypted_size(&impl, src_size, &dest_size, aes::ErrorDetailsThrowsInDestructor{});
+        return dest_size;
+    }
 
-        aes_box_encrypt_buffer(
-            &impl, src_buf, src_size, nullptr, &dest_size, aes::ErrorDetailsThrowsInDestructor{}
+    std::size_t max_decrypted_size(std::size_t src_size) const {
+        std::size_t dest_size = 0;
+        aes_box_max_decrypted_size(
+            &impl, src_size, &dest_size, aes::ErrorDetailsThrowsInDestructor{}
         );
+        return dest_size;
+    }
+
+    Buffer encrypt_buffer(const void* src_buf, std::size_t src_size) {
+        Buffer dest_buf;
+        encrypt_buffer(std::span{static_cast<const std::byte*>(src_buf), src_size}, dest_buf);
+        return dest_buf;
+    }
+
+    Buffer decrypt_buffer(const void* src_buf, std::size_t src_size) {
+        Buffer dest_buf;
+        decrypt_buffer(std::span{static_cast<const std::byte*>(src_buf), src_size}, dest_buf);
+        return dest_buf;
+    }
 
-        std::vector<unsigned char> dest_buf;
-        dest_buf.resize(dest_size);
+    // dest must be large enough to hold the result, see encrypted_size & max_decrypted_size.
+    // These return the number of bytes written.
+
+    std::size_t encrypt_buffer(std::span<const std::byte> src, std::span<std::byte> dest) {
+        std::size_t dest_size = encrypted_size(src.size());
+        if (dest.size() < dest_size)
+            aes_error_buffer_too_small(aes::ErrorDetailsThrowsInDestructor{});
 
         aes_box_encrypt_buffer(
             &impl,
-            src_buf,
-            src_size,
-            dest_buf.data(),
+            src.data(),
+            src.size(),
+            dest.data(),
             &dest_size,
             aes::ErrorDetailsThrowsInDestructor{}
         );
 
-        dest_buf.resize(dest_size);
-        return dest_buf;
+        return dest_size;
     }
 
-    std::vector<unsigned char> decrypt_buffer(const void* src_buf, std::size_t src_size) {
-        std::size_t dest_size = 0;
+    std::size_t decrypt_buffer(std::span<const std::byte> src, std::span<std::byte> dest) {
+        std::size_t dest_size = max_decrypted_size(src.size());
+        if (dest.size() < dest_size)
+            aes_error_buffer_too_small(aes::ErrorDetailsThrowsInDestructor{});
 
         aes_box_decrypt_buffer(
-            &impl, src_buf, src_size, nullptr, &dest_size, aes::ErrorDetailsThrowsInDestructor{}
+            &impl,
+            src.data(),
+            src.size(),
+            dest.data(),
+            &dest_size,
+            aes::ErrorDetailsThrowsInDestructor{}
         );
 
-        std::vector<unsigned char> dest_buf;
-        dest_buf.resize(dest_size);
+        return dest_size;
+    }
+
+    // These append the result to dest, which is left unchanged if an exception is thrown.
+    // It's resized before the result is written, use a container that doesn't zero out the new
+    // elements (like Buffer) to avoid paying for that.
 
-        aes_box_decrypt_buffer(
+    template <ByteContainer Container>
+    void encrypt_buffer(std::span<const std::byte> src, Container& dest) {
+        const auto offset = dest.size();
+        dest.resize(offset + encrypted_size(src.size()));
+        const auto tail = std::as_writable_bytes(std::span{dest}).subspan(offset);
+        std::size_t size = 0;
+        try {
+            size = encrypt_buffer(src, tail);
+        } catch (...) {
+            dest.resize(offset);
+            throw;
+        }
+        dest.resize(offset + size);
+    }
+
+    template <ByteContainer Container>
+    void decrypt_buffer(std::span<const std::byte> src, Container& dest) {
+        const auto offset = dest.size();
+        dest.resize(offset + max_decrypted_size(src.size()));
+        const auto tail = std::as_writable_bytes(std::span{dest}).subspan(offset);
+        std::size_t size = 0;
+        try {
+            size = decrypt_buffer(src, tail);
+        } catch (...) {
+            dest.resize(offset);
+            throw;
+        }
+        dest.resize(offset + size);
+    }
+
+    // buf must be large enough to hold the ciphertext, see encrypted_size.
+    // These return the size of the result.
+
+    std::size_t encrypt_inplace(void* buf, std::size_t src_size) {
+        std::size_t dest_size = 0;
+        aes_box_encrypt_inplace(
+            &impl, buf, src_size, &dest_size, aes::ErrorDetailsThrowsInDestructor{}
+        );
+        return dest_size;
+    }
+
+    std::size_t decrypt_inplace(void* buf, std::size_t src_size) {
+        std::size_t dest_size = 0;
+        aes_box_decrypt_inplace(
+            &impl, buf, src_size, &dest_size, aes::ErrorDetailsThrowsInDestructor{}
+        );
+        return dest_size;
+    }
+
+    // The buffer is resized to fit the result.
+
+    void encrypt_inplace(Buffer& buf) {
+        const auto src_size = buf.size();
+        buf.resize(encrypted_size(src_size));
+        buf.resize(encrypt_inplace(buf.data(), src_size));
+    }
+
+    void decrypt_inplace(Buffer& buf) {
+        buf.resize(decrypt_inplace(buf.data(), buf.size()));
+    }
+
+    // The message is the concatenation of the src segments, the result fills the dest segments
+    // in order (see aes_box_encrypt_iov).
+    // These return the size of the result.
+
+    std::size_t encrypt_iov(std::span<const AES_IoVec> src, std::span<const AES_IoVec> dest) {
+        std::size_t dest_size = 0;
+        aes_box_encrypt_iov(
             &impl,
-            src_buf,
-            src_size,
-            dest_buf.data(),
+            src.data(),
+            src.size(),
+            dest.data(),
+            dest.size(),
             &dest_size,
             aes::ErrorDetailsThrowsInDestructor{}
         );
+        return dest_size;
+    }
 
-        dest_buf.resize(dest_size);
-        return dest_buf;
+    std::size_t decrypt_iov(std::span<const AES_IoVec> src, std::span<const AES_IoVec> dest) {
+        std::size_t dest_size = 0;
+        aes_box_decrypt_iov(
+            &impl,
+            src.data(),
+            src.size(),
+            dest.data(),
+            dest.size(),
+            &dest_size,
+            aes::ErrorDetailsThrowsInDestructor{}
+        );
+        return dest_size;
+    }
+
+    // The segments are converted to AES_IoVec on the stack, unless there are more than
+    // IoVecList::max_inline_size of them.
+
+    std::size_t encrypt_iov(
+        std::span<const std::span<const std::byte>> src,
+        std::span<const std::span<std::byte>> dest
+    ) {
+        return encrypt_iov(IoVecList{src}.get(), IoVecList{dest}.get());
+    }
+
+    std::size_t decrypt_iov(
+        std::span<const std::span<const std::byte>> src,
+        std::span<const std::span<std::byte>> dest
+    ) {
+        return decrypt_iov(IoVecList{src}.get(), IoVecList{dest}.get());
+    }
+
+    // The update functions write at most src_size + 15 bytes, the finalize functions write at
+    // most AES_BOX_FINALIZE_MAX_SIZE bytes.
+    // They return the number of bytes written.
+
+    std::size_t encrypt_update(const void* src_buf, std::size_t src_size, void* dest_buf) {
+        std::size_t written = 0;
+        aes_box_encrypt_update(
+            &impl, src_buf, src_size, dest_buf, &written, aes::ErrorDetailsThrowsInDestructor{}
+        );
+        return written;
+    }
+
+    std::size_t encrypt_finalize(void* dest_buf) {
+        std::size_t written = 0;
+        aes_box_encrypt_finalize(&impl, dest_buf, &written, aes::ErrorDetailsThrowsInDestructor{});
+        return written;
+    }
+
+    std::size_t decrypt_update(const void* src_buf, std::size_t src_size, void* dest_buf) {
+        std::size_t written = 0;
+        aes_box_decrypt_update(
+            &impl, src_buf, src_size, dest_buf, &written, aes::ErrorDetailsThrowsInDestructor{}
+        );
+        return written;
+    }
+
+    std::size_t decrypt_finalize(void* dest_buf) {
+        std::size_t written = 0;
+        aes_box_decrypt_finalize(&impl, dest_buf, &written, aes::ErrorDetailsThrowsInDestructor{});
+        return written;
+    }
+
+    void set_iv(const Block& iv) {
+        aes_box_set_iv(&impl, iv.ptr(), aes::ErrorDetailsThrowsInDestructor{});
+    }
+
+    void set_aad(const void* aad_buf, std::size_t aad_size) {
+        aes_box_set_aad(&impl, aad_buf, aad_size, aes::ErrorDetailsThrowsInDestructor{});
+    }
+
+    Block get_tag() const {
+        Block tag;
+        aes_box_get_tag(&impl, tag.ptr(), aes::ErrorDetailsThrowsInDestructor{});
+        return tag;
+    }
+
+    void encrypt_sectors(
+        const void* src_buf,
+        std::size_t sector_size,
+        std::size_t numof_sectors,
+        unsigned long long first_sector,
+        void* dest_buf
+    ) {
+        aes_box_encrypt_sectors(
+            &impl,
+            src_buf,
+            sector_size,
+            numof_sectors,
+            first_sector,
+            dest_buf,
+            aes::ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+    void decrypt_sectors(
+        const void* src_buf,
+        std::size_t sector_size,
+        std::size_t numof_sectors,
+        unsigned long long first_sector,
+        void* dest_buf
+    ) {
+        aes_box_decrypt_sectors(
+            &impl,
+            src_buf,
+            sector_size,
+            numof_sectors,
+            first_sector,
+            dest_buf,
+            aes::ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+    void generate_keystream(void* dest_buf, std::size_t dest_size) {
+        aes_box_generate_keystream(
+            &impl, dest_buf, dest_size, aes::ErrorDetailsThrowsInDestructor{}
+        );
     }
 
 private:
+    class IoVecList {
+    public:
+        static constexpr std::size_t max_inline_size = 16;
+
+        template <typename Byte>
+        explicit IoVecList(std::span<const std::span<Byte>> segments) : size{segments.size()} {
+            AES_IoVec* iov = inline_iov.data();
+            if (size > max_inline_size) {
+                heap_iov.resize(size);
+                iov = heap_iov.data();
+            }
+            for (const auto& segment : segments)
+                *iov++ = {const_cast<std::byte*>(segment.data()), segment.size()};
+        }
+
+        std::span<const AES_IoVec> get() const {
+            if (size > max_inline_size)
+                return heap_iov;
+            return std::span{inline_iov}.first(size);
+        }
+
+    private:
+        std::array<AES_IoVec, max_inline_size> inline_iov;
+        std::vector<AES_IoVec> heap_iov;
+        std::size_t size;
+    };
+
     void dump_key(const Key& src) const {
         if (verbose)
             std::cout << std::format("Key         : {}\n", src.to_string());
@@ -144,4 +444,15 @@ private:
     bool verbose = false;
 };
 
+inline void apply_keystream(
+    const void* src_buf,
+    std::size_t src_size,
+    const void* keystream_buf,
+    void* dest_buf
+) {
+    aes_apply_keystream(
+        src_buf, src_size, keystream_buf, dest_buf, aes::ErrorDetailsThrowsInDestructor{}
+    );
+}
+
 } // namespace aes
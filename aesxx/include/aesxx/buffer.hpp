@@ -0,0 +1,53 @@
+// Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+// This file is part of the "AES tools" project.
+// For details, see https://github.com/egor-tensin/aes-tools.
+// Distributed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aes {
+
+// Default-initializes the elements instead of value-initializing them, so that resizing a buffer
+// of bytes doesn't zero it out.
+template <typename T>
+class DefaultInitAllocator : public std::allocator<T> {
+public:
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    using std::allocator<T>::allocator;
+
+    template <typename U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        std::construct_at(ptr, std::forward<Args>(args)...);
+    }
+};
+
+// The buffers returned by Box are always overwritten right after they're allocated.
+using Buffer = std::vector<unsigned char, DefaultInitAllocator<unsigned char>>;
+
+// A resizable contiguous container of bytes (like Buffer, std::vector<std::byte> or std::string)
+// the output can be appended to.
+template <typename Container>
+concept ByteContainer = std::ranges::contiguous_range<Container> &&
+                        sizeof(std::ranges::range_value_t<Container>) == 1 &&
+                        requires(Container& container, std::size_t size) {
+                            container.resize(size);
+                        };
+
+} // namespace aes
@@ -0,0 +1,52 @@
+// Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+// This file is part of the "AES tools" project.
+// For details, see https://github.com/egor-tensin/aes-tools.
+// Distributed under the MIT License.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "block.hpp"
+#include "error.hpp"
+#include "key.hpp"
+
+#include <aes/all.h>
+
+#include <cstddef>
+
+namespace aes {
+
+class Cmac {
+public:
+    Cmac(Algorithm algorithm, const Key& key) {
+        aes_cmac_init(&impl, algorithm, key.ptr(), ErrorDetailsThrowsInDestructor{});
+    }
+
+    Block compute(const void* src_buf, std::size_t src_size) const {
+        Block mac;
+        aes_cmac_compute(&impl, src_buf, src_size, mac.ptr(), ErrorDetailsThrowsInDestructor{});
+        return mac;
+    }
+
+    void compute_batch(
+        const void* const* src_bufs,
+        const std::size_t* src_sizes,
+        std::size_t numof_messages,
+        Block* macs
+    ) const {
+        static_assert(sizeof(Block) == sizeof(AES_Block));
+        aes_cmac_compute_batch(
+            &impl,
+            src_bufs,
+            src_sizes,
+            numof_messages,
+            reinterpret_cast<AES_Block*>(macs),
+            ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+private:
+    AES_Cmac impl;
+};
+
+} // namespace aes
@@ -0,0 +1,83 @@
+// Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+// This file is part of the "AES tools" project.
+// For details, see https://github.com/egor-tensin/aes-tools.
+// Distributed under the MIT License.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "error.hpp"
+
+#include <aes/all.h>
+
+#include <cstddef>
+
+namespace aes {
+
+class CtrDrbg {
+public:
+    CtrDrbg(
+        Algorithm algorithm,
+        bool use_df,
+        const void* entropy,
+        std::size_t entropy_size,
+        const void* nonce = nullptr,
+        std::size_t nonce_size = 0,
+        const void* personalization = nullptr,
+        std::size_t personalization_size = 0
+    ) {
+        aes_ctr_drbg_init(
+            &impl,
+            algorithm,
+            use_df ? 1 : 0,
+            entropy,
+            entropy_size,
+            nonce,
+            nonce_size,
+            personalization,
+            personalization_size,
+            ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+    void reseed(
+        const void* entropy,
+        std::size_t entropy_size,
+        const void* additional = nullptr,
+        std::size_t additional_size = 0
+    ) {
+        aes_ctr_drbg_reseed(
+            &impl,
+            entropy,
+            entropy_size,
+            additional,
+            additional_size,
+            ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+    void generate(
+        void* dest_buf,
+        std::size_t dest_size,
+        const void* additional = nullptr,
+        std::size_t additional_size = 0
+    ) {
+        aes_ctr_drbg_generate(
+            &impl,
+            dest_buf,
+            dest_size,
+            additional,
+            additional_size,
+            ErrorDetailsThrowsInDestructor{}
+        );
+    }
+
+    static void generate_thread_local(void* dest_buf, std::size_t dest_size) {
+        aes_ctr_drbg_generate_thread_local(dest_buf, dest_size, ErrorDetailsThrowsInDestructor{});
+    }
+
+private:
+    AES_CtrDrbg impl;
+};
+
+} // namespace aes
@@ -28,6 +28,9 @@ public:
         fill_call_stack(err_details);
     }
 
+    // Without the details, the message is aes_strerror's & the call stack is empty.
+    explicit Error(AES_StatusCode ec) : std::runtime_error{aes_strerror(ec)} {}
+
     void for_each_addr(const std::function<void(const void*, const std::string&)>& callback) const {
         aux::CallStackFormatter formatter;
 
@@ -71,7 +74,7 @@ inline std::ostream& operator<<(std::ostream& os, const Error& error) {
 class ErrorDetailsThrowsInDestructor {
 public:
     ErrorDetailsThrowsInDestructor() {
-        aes_success(get());
+        impl.ec = AES_SUCCESS;
     }
 
     ~ErrorDetailsThrowsInDestructor() noexcept(false) {
@@ -91,4 +94,17 @@ private:
     AES_ErrorDetails impl;
 };
 
+// Calls fn(AES_ErrorDetails*) in the compact mode (see aes/error.h), so that the ~500-byte
+// AES_ErrorDetails isn't touched & the call stack isn't captured unless fn fails.
+// It's then called again to throw an Error with the details, so fn mustn't have side effects when
+// it fails.
+template <typename Fn>
+void call_with_lazy_error_details(Fn&& fn) {
+    const AES_StatusCode ec = fn(nullptr);
+    if (aes_is_error(ec)) [[unlikely]] {
+        fn(ErrorDetailsThrowsInDestructor{});
+        throw Error{ec};
+    }
+}
+
 } // namespace aes
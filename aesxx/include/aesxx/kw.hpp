@@ -0,0 +1,66 @@
+// Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+// This file is part of the "AES tools" project.
+// For details, see https://github.com/egor-tensin/aes-tools.
+// Distributed under the MIT License.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "error.hpp"
+#include "key.hpp"
+
+#include <aes/all.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace aes {
+
+class Kw {
+public:
+    Kw(Algorithm algorithm, const Key& kek) {
+        aes_kw_init(&impl, algorithm, kek.ptr(), ErrorDetailsThrowsInDestructor{});
+    }
+
+    std::vector<unsigned char> wrap(const void* src_buf, std::size_t src_size) const {
+        return call(&aes_kw_wrap, src_buf, src_size);
+    }
+
+    std::vector<unsigned char> unwrap(const void* src_buf, std::size_t src_size) const {
+        return call(&aes_kw_unwrap, src_buf, src_size);
+    }
+
+    std::vector<unsigned char> wrap_with_padding(const void* src_buf, std::size_t src_size) const {
+        return call(&aes_kwp_wrap, src_buf, src_size);
+    }
+
+    std::vector<unsigned char> unwrap_with_padding(
+        const void* src_buf,
+        std::size_t src_size
+    ) const {
+        return call(&aes_kwp_unwrap, src_buf, src_size);
+    }
+
+private:
+    using Function = AES_StatusCode (*)(
+        const AES_Kw*, const void*, std::size_t, void*, std::size_t*, AES_ErrorDetails*
+    );
+
+    std::vector<unsigned char> call(Function fn, const void* src_buf, std::size_t src_size) const {
+        std::size_t dest_size = 0;
+
+        fn(&impl, src_buf, src_size, nullptr, &dest_size, ErrorDetailsThrowsInDestructor{});
+
+        std::vector<unsigned char> dest_buf;
+        dest_buf.resize(dest_size);
+
+        fn(&impl, src_buf, src_size, dest_buf.data(), &dest_size, ErrorDetailsThrowsInDestructor{});
+
+        dest_buf.resize(dest_size);
+        return dest_buf;
+    }
+
+    AES_Kw impl;
+};
+
+} // namespace aes
@@ -10,6 +10,7 @@
 
 #include <boost/program_options.hpp>
 
+#include <cstddef>
 #include <exception>
 #include <format>
 #include <iostream>
@@ -18,22 +19,48 @@
 
 namespace {
 
+constexpr std::size_t chunk_size = 64 * 1024;
+
+void decrypt_file_in_chunks(
+    aes::Box& box,
+    const std::string& ciphertext_path,
+    const std::string& plaintext_path
+) {
+    auto ifs = file::open_input(ciphertext_path);
+    auto ofs = file::open_output(plaintext_path);
+
+    std::vector<unsigned char> ciphertext_buf(chunk_size);
+    std::vector<unsigned char> plaintext_buf(chunk_size + AES_BOX_FINALIZE_MAX_SIZE);
+
+    while (const auto ciphertext_size =
+               file::read_chunk(ifs, ciphertext_buf.data(), ciphertext_buf.size())) {
+        const auto plaintext_size =
+            box.decrypt_update(ciphertext_buf.data(), ciphertext_size, plaintext_buf.data());
+        file::write_chunk(ofs, plaintext_buf.data(), plaintext_size);
+    }
+
+    file::write_chunk(ofs, plaintext_buf.data(), box.decrypt_finalize(plaintext_buf.data()));
+}
+
 void decrypt_file(
     aes::Box& box,
     const std::string& ciphertext_path,
     const std::string& plaintext_path
 ) {
-    const auto ciphertext_buf = file::read(ciphertext_path);
-    const auto plaintext_buf = box.decrypt_buffer(ciphertext_buf.data(), ciphertext_buf.size());
-    file::write(plaintext_path, plaintext_buf);
+    // In authenticated modes, the whole message is decrypted first, so that nothing is written
+    // unless the tag matches.
+    if (aes_mode_supports_streaming(box.get_mode()) && !aes_mode_is_authenticated(box.get_mode())) {
+        decrypt_file_in_chunks(box, ciphertext_path, plaintext_path);
+        return;
+    }
+
+    auto buf = file::read<aes::Buffer>(ciphertext_path);
+    box.decrypt_inplace(buf);
+    file::write(plaintext_path, buf);
 }
 
 void decrypt_file(const FileSettings& settings) {
-    const auto algorithm = settings.get_algorithm();
-    const auto mode = settings.get_mode();
-    const auto key = aes::Key::parse(settings.get_key(), algorithm);
-
-    aes::Box box{algorithm, key, mode, settings.get_iv()};
+    auto box = settings.make_box();
     decrypt_file(box, settings.get_input_path(), settings.get_output_path());
 }
 
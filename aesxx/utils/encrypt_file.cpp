@@ -10,6 +10,7 @@
 
 #include <boost/program_options.hpp>
 
+#include <cstddef>
 #include <exception>
 #include <format>
 #include <iostream>
@@ -18,22 +19,46 @@
 
 namespace {
 
+constexpr std::size_t chunk_size = 64 * 1024;
+
+void encrypt_file_in_chunks(
+    aes::Box& box,
+    const std::string& plaintext_path,
+    const std::string& ciphertext_path
+) {
+    auto ifs = file::open_input(plaintext_path);
+    auto ofs = file::open_output(ciphertext_path);
+
+    std::vector<unsigned char> plaintext_buf(chunk_size);
+    std::vector<unsigned char> ciphertext_buf(chunk_size + AES_BOX_FINALIZE_MAX_SIZE);
+
+    while (const auto plaintext_size =
+               file::read_chunk(ifs, plaintext_buf.data(), plaintext_buf.size())) {
+        const auto ciphertext_size =
+            box.encrypt_update(plaintext_buf.data(), plaintext_size, ciphertext_buf.data());
+        file::write_chunk(ofs, ciphertext_buf.data(), ciphertext_size);
+    }
+
+    file::write_chunk(ofs, ciphertext_buf.data(), box.encrypt_finalize(ciphertext_buf.data()));
+}
+
 void encrypt_file(
     aes::Box& box,
     const std::string& plaintext_path,
     const std::string& ciphertext_path
 ) {
-    const auto plaintext_buf = file::read(plaintext_path);
-    const auto ciphertext_buf = box.encrypt_buffer(plaintext_buf.data(), plaintext_buf.size());
-    file::write(ciphertext_path, ciphertext_buf);
+    if (aes_mode_supports_streaming(box.get_mode())) {
+        encrypt_file_in_chunks(box, plaintext_path, ciphertext_path);
+        return;
+    }
+
+    auto buf = file::read<aes::Buffer>(plaintext_path);
+    box.encrypt_inplace(buf);
+    file::write(ciphertext_path, buf);
 }
 
 void encrypt_file(const FileSettings& settings) {
-    const auto algorithm = settings.get_algorithm();
-    const auto mode = settings.get_mode();
-    const auto key = aes::Key::parse(settings.get_key(), algorithm);
-
-    aes::Box box{algorithm, key, mode, settings.get_iv()};
+    auto box = settings.make_box();
     encrypt_file(box, settings.get_input_path(), settings.get_output_path());
 }
 
@@ -3,6 +3,8 @@
 // For details, see https://github.com/egor-tensin/aes-tools.
 // Distributed under the MIT License.
 
+#include <aesxx/all.hpp>
+
 #include <windows.h>
 
 #include <cstddef>
@@ -36,7 +38,7 @@ public:
         return get_size() - get_header_size();
     }
 
-    void replace_pixels(std::vector<unsigned char>&& pixels) {
+    void replace_pixels(const aes::Buffer& pixels) {
         buffer.resize(get_header_size() + pixels.size());
         std::memcpy(buffer.data() + get_header_size(), pixels.data(), pixels.size());
     }
@@ -82,6 +82,20 @@ public:
         return {};
     }
 
+    // In XTS mode, the key is the data key followed by the tweak key.
+    aes::Box make_box() const {
+        if (mode == AES_XTS) {
+            const auto half = key.size() / 2;
+            return aes::Box{
+                algorithm,
+                aes::Key::parse(key.substr(0, half), algorithm),
+                aes::Key::parse(key.substr(half), algorithm),
+                get_iv()
+            };
+        }
+        return aes::Box{algorithm, aes::Key::parse(key, algorithm), mode, get_iv()};
+    }
+
 private:
     aes::Algorithm algorithm;
     aes::Mode mode;
@@ -29,6 +29,11 @@ inline void validate(any& dest, const std::vector<std::string>& values, aes::Mod
         {"cfb", AES_CFB},
         {"ofb", AES_OFB},
         {"ctr", AES_CTR},
+        {"gcm", AES_GCM},
+        {"xts", AES_XTS},
+        {"ccm", AES_CCM},
+        {"ocb", AES_OCB},
+        {"gcm-siv", AES_GCM_SIV},
     };
 
     const auto it = lookup_table.find(algorithm::to_lower_copy(src));
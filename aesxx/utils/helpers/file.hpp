@@ -30,19 +30,47 @@ inline std::size_t get_size(const std::string& path) {
     return cast_to_size_t(ifs.tellg());
 }
 
-inline std::vector<char> read(const std::string& path) {
+template <typename Buffer = std::vector<char>>
+inline Buffer read(const std::string& path) {
     const auto size = get_size(path);
 
     std::ifstream ifs;
     ifs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
     ifs.open(path, std::ifstream::binary);
 
-    std::vector<char> src_buf;
+    Buffer src_buf;
     src_buf.reserve(size);
     src_buf.assign(std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{});
     return src_buf;
 }
 
+// Unlike read & write, these don't consider hitting the end of the file to be an error, so that a
+// file can be processed in chunks.
+
+inline std::ifstream open_input(const std::string& path) {
+    std::ifstream ifs;
+    ifs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+    ifs.open(path, std::ifstream::binary);
+    ifs.exceptions(std::ifstream::badbit);
+    return ifs;
+}
+
+inline std::ofstream open_output(const std::string& path) {
+    std::ofstream ofs;
+    ofs.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+    ofs.open(path, std::ofstream::binary);
+    return ofs;
+}
+
+inline std::size_t read_chunk(std::ifstream& ifs, void* buffer, std::size_t size) {
+    ifs.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    return cast_to_size_t(ifs.gcount());
+}
+
+inline void write_chunk(std::ofstream& ofs, const void* buffer, std::size_t size) {
+    ofs.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(size));
+}
+
 inline void write(const std::string& path, const void* buffer, const std::size_t size) {
     std::ofstream ofs;
     ofs.exceptions(std::ofstream::badbit | std::ofstream::failbit);
@@ -50,7 +78,8 @@ inline void write(const std::string& path, const void* buffer, const std::size_t
     ofs.write(reinterpret_cast<const char*>(buffer), size);
 }
 
-inline void write(const std::string& path, const std::vector<unsigned char>& src) {
+template <typename Buffer>
+inline void write(const std::string& path, const Buffer& src) {
     write(path, src.data(), src.size());
 }
 
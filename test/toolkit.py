@@ -70,7 +70,9 @@ class Mode(Enum):
         except ValueError:
             return None
 
-    ECB, CBC, CFB, OFB, CTR = "ecb", "cbc", "cfb", "ofb", "ctr"
+    ECB, CBC, CFB, OFB, CTR, GCM, XTS, CCM, OCB, GCM_SIV = (
+        "ecb", "cbc", "cfb", "ofb", "ctr", "gcm", "xts", "ccm", "ocb", "gcm-siv"
+    )
 
     def requires_init_vector(self):
         return self != Mode.ECB
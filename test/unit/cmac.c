@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+/* The examples from RFC 4493 (AES-128) & NIST SP 800-38B (AES-192 & AES-256):
+ * the first 0, 16, 40 & 64 bytes of the same message. */
+
+static const char* const message =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+static const size_t message_sizes[] = {0, 16, 40, 64};
+
+typedef struct {
+    AES_Algorithm algorithm;
+    const char* key;
+    const char* macs[4];
+} KnownAnswer;
+
+static const KnownAnswer known_answers[] = {
+    {
+        AES_AES128,
+        "2b7e151628aed2a6abf7158809cf4f3c",
+        {
+            "bb1d6929e95937287fa37d129b756746",
+            "070a16b46b4d4144f79bdd9dd04a287c",
+            "dfa66747de9ae63030ca32611497c827",
+            "51f0bebf7e3b9d92fc49741779363cfe",
+        },
+    },
+    {
+        AES_AES192,
+        "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b",
+        {
+            "d17ddf46adaacde531cac483de7a9367",
+            "9e99a7bf31e710900662f65e617c5184",
+            "8a1de5be2eb31aad089a82e6ee908b0e",
+            "a1d5df0eed790f794d77589659f39a11",
+        },
+    },
+    {
+        AES_AES256,
+        "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+        {
+            "028962f61b7bf89efc6b551f4667d983",
+            "28a7023f452e8f82bd4bf28d8c37c35c",
+            "aaf3d8f1de5640c232f5b169b9c911e6",
+            "e1992190549f6ed5696a2c056c315410",
+        },
+    },
+};
+
+static void test_known_answer(const KnownAnswer* known_answer) {
+    unsigned char src[64];
+    AES_Key key;
+    AES_Cmac cmac;
+
+    test_parse_hex(message, src);
+
+    if (!TEST_CHECK_SUCCESS(aes_parse_key(known_answer->algorithm, &key, known_answer->key, NULL)))
+        return;
+    if (!TEST_CHECK_SUCCESS(aes_cmac_init(&cmac, known_answer->algorithm, &key, NULL)))
+        return;
+
+    for (size_t i = 0; i < sizeof(message_sizes) / sizeof(message_sizes[0]); ++i) {
+        unsigned char expected[16];
+        AES_Block mac;
+
+        test_parse_hex(known_answer->macs[i], expected);
+        TEST_CHECK_SUCCESS(aes_cmac_compute(&cmac, src, message_sizes[i], &mac, NULL));
+        if (!TEST_CHECK(memcmp(&mac, expected, sizeof(expected)) == 0))
+            fprintf(
+                stderr,
+                "algorithm %d, %zu bytes\n",
+                (int)known_answer->algorithm,
+                message_sizes[i]
+            );
+    }
+}
+
+#define NUMOF_MESSAGES (2 * AES_CMAC_BATCH_LEN + 5)
+
+static unsigned char messages[NUMOF_MESSAGES][TEST_MAX_MESSAGE_SIZE];
+
+/* The batch function must compute the same MACs as the messages would have
+ * one by one, for batches of any size & messages of any (different) sizes. */
+static void test_batch(AES_Algorithm algorithm, size_t numof_messages) {
+    const void* srcs[NUMOF_MESSAGES];
+    size_t src_sizes[NUMOF_MESSAGES];
+    AES_Block macs[NUMOF_MESSAGES];
+    AES_Key key;
+    AES_Cmac cmac;
+
+    test_fill(&key, sizeof(key), (unsigned int)algorithm);
+    if (!TEST_CHECK_SUCCESS(aes_cmac_init(&cmac, algorithm, &key, NULL)))
+        return;
+
+    for (size_t i = 0; i < numof_messages; ++i) {
+        src_sizes[i] = test_get_message_size((i * 7 + numof_messages) % TEST_NUMOF_MESSAGE_SIZES);
+        test_fill(messages[i], src_sizes[i], (unsigned int)i);
+        srcs[i] = messages[i];
+    }
+
+    TEST_CHECK_SUCCESS(aes_cmac_compute_batch(&cmac, srcs, src_sizes, numof_messages, macs, NULL));
+
+    for (size_t i = 0; i < numof_messages; ++i) {
+        AES_Block expected;
+
+        TEST_CHECK_SUCCESS(aes_cmac_compute(&cmac, srcs[i], src_sizes[i], &expected, NULL));
+        if (!TEST_CHECK(memcmp(&macs[i], &expected, sizeof(expected)) == 0))
+            fprintf(
+                stderr,
+                "algorithm %d, message %zu of %zu (%zu bytes)\n",
+                (int)algorithm,
+                i,
+                numof_messages,
+                src_sizes[i]
+            );
+    }
+}
+
+int main(void) {
+    static const size_t batch_sizes[] = {
+        0,
+        1,
+        7,
+        AES_CMAC_BATCH_LEN - 1,
+        AES_CMAC_BATCH_LEN,
+        AES_CMAC_BATCH_LEN + 1,
+        NUMOF_MESSAGES,
+    };
+
+    for (size_t i = 0; i < sizeof(known_answers) / sizeof(known_answers[0]); ++i)
+        test_known_answer(&known_answers[i]);
+
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); ++i)
+            test_batch((AES_Algorithm)algorithm, batch_sizes[i]);
+
+    return test_finish("cmac");
+}
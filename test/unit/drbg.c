@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+#ifndef WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+    AES_Algorithm algorithm;
+    int use_df;
+    const char* entropy;
+    const char* nonce;
+    const char* personalization;
+    const char* entropy_reseed;
+    const char* additional_reseed;
+    const char* additional1;
+    const char* additional2;
+    const char* returned;
+} KnownAnswer;
+
+/* These follow the CAVP CTR_DRBG test procedure (see drbgtestvectors.zip):
+ * instantiate, reseed if there's reseed entropy, generate 64 bytes twice &
+ * check the second output. The input sizes are the ones CAVP uses: with the
+ * derivation function, the entropy input is as long as the key & the nonce is
+ * half as long; without it, the entropy input is seedlen bytes.
+ * The answers were computed with OpenSSL's CTR-DRBG (3.0, the "TEST-RAND"
+ * entropy source). */
+static const KnownAnswer known_answers[] = {
+    {
+        AES_AES128,
+        1,
+        "c665a7742ac3ffdb8c822c1d4c08ab4d",
+        "06c11ecd16a66f62",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "7b715ad8570f67c3cdb5b7a0160e61f74e7916f07dd8a58b9232d16fb8f4fa9c6e400139964c8f2d"
+        "dafbdba450db38b813c62196763f4c5bab4d0cacd5ba046e",
+    },
+    {
+        AES_AES128,
+        1,
+        "4f784a8bf5a1539e9f1314bbe8ad2587",
+        "7b53980c85c1e307",
+        "2a42957a07068c9c2e3dea3195aff8ea",
+        "a14360855bd6f2bb166ac2179203af24",
+        "a2e5292344e66c8df2f1bf3939b8e08f",
+        "ff7846009454ee2c4bff97e98be2a93d",
+        "aecf679c274afc3140e1e0ee42a69666",
+        "20dbf3e09d06c4c8cba996b00ce00d7d3fc30276860a12d07d1530a45beab7ae4c46aa27537812a7"
+        "147f18ed487b2a3e9c681979cf3566349ea02fd39d8f0a4d",
+    },
+    {
+        AES_AES128,
+        0,
+        "233ab93c3c23ab3beba8fe37e77ea1a7e36a63d8141f7651841f14c2e00d9d57",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "3cbd0eab200987efeb06ad573cd3b7d6c3138415b8dea5a640b600d74e67362f9a219835493cb309"
+        "a9c5abbabcce5973262fa2f11b585b7a8cc99d1ce2b147f0",
+    },
+    {
+        AES_AES128,
+        0,
+        "0221a63a37b1f45c09f002961009f756ea27061f9450319d79f28c775f1d10f1",
+        "",
+        "5d2f83ea52f09bf13eeda8a5331f563b2cca58e8259e125be0380c22b529f205",
+        "8778e4b45a53850d6175fd92fa9e1e6bd0c350199fc1dda29ca0a8499546f072",
+        "d6f93c15f2b2351751b2104161178474bf31ddda2b4edf66220b4fd923e59ea0",
+        "f288a4d42c599cb206917d15c508a545d8d3d3831135648e2ebbc6645545d318",
+        "b8caf16043c2815193c60cc97d96d16816aada94442869dd0f6fd06330cfb0b8",
+        "be5e21e7c95f61e9cc5ce78cd86bd24b9b07cd2ea329f2fe52b961300c4d93a7631882e1ca107f05"
+        "fadcd428f6e5a87887e45ee9493365ee3dd07131240ab045",
+    },
+    {
+        AES_AES192,
+        1,
+        "cea25b7c6b0ef6737f5a7aa197074410f86546add236094d",
+        "898f22b670fc5e2e5c4515bb",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "001653407d7ff031c5c9ad2d166fae013b1603974f7ce1a9cc5de4365cc6e9cae880325a9ef98600"
+        "2a4b0206de96e0eae75222bd8c8e4cea62b24e310371c42f",
+    },
+    {
+        AES_AES192,
+        1,
+        "74c967e3095104185f36fb402246877a0b5154911994a219",
+        "ade22751ec574f44a2b18569",
+        "11cdf1b61d2ecfdfdb5587b5c148492d3c494328a491bc6d",
+        "5a393e9716eefd27f86626969ad2b15a62a04585103f7141",
+        "fd8c25863f9b9d0a659e086c5c388134525f05d9b4fbd15d",
+        "962a78234aa9c56387aa3b4b185300e7a5195917dbe9b570",
+        "9ea57a211d4ca6097bf9e8b87baa18b4f4566dd3920821d3",
+        "dbd7bb8209efa4669b1b08ad543657ebbf725e5790ce6a19d2567ddceb42bdc7d03222fffa9c965f"
+        "d9e741c93ac9df11ed1e3a202b15313b0674e54a1eb84432",
+    },
+    {
+        AES_AES192,
+        0,
+        "62f8a13719ced87b1f01a09281642c6b7e08164efb6bd96558bb164f9ad3e39f3c2738ddb18c7df3",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "9b5a6cb17f3253cd05e52997a157bd9da30c3f2463f70c89c4963d7836d5a770afabb528c8f0342d"
+        "8f5a9211c798c26ae84ba1041c8b5c920b7b43265166ed5e",
+    },
+    {
+        AES_AES192,
+        0,
+        "59e8ffd43fae8da7c18b08588dccd46dde61c3a911ed316ef955f269a24197e91153d32a8f9bc8fc",
+        "",
+        "065d270345701a9b7a201bf8affeed57459e25016525f30897369fa7a491ef7f7c58c41bfbc433cb",
+        "c92ffc73b27f319ba8d9ed016e6fb5c9b5fc0a188f4e14cffe04737aced6891272e21ed64d0e6b26",
+        "2fb343f4fec2a73357c0c60f3db486dbe02d17daa8a4b335be2589a921e8f429f90f8607f8adc3ea",
+        "b69adacb6df88c5270568d9de0d9391a72dedb251bff1790010d5a439cc38dcb8b20dd1ab3b31798",
+        "5bcd8c9df3044a75c984a79def0d5f0808740890957553f5320f7eba27359f76ce3472fe2f264188",
+        "6f59da1c701ce6d575ac6a27d59e73d755042ff899541801c6f5901b53fbe261ae3ae391efdc2d99"
+        "e125d0eb45ec7fa24a28c6125a67a395102d11c0236178ec",
+    },
+    {
+        AES_AES256,
+        1,
+        "9d0a433870322dbc0c8344a32a9c6ff5630a32372498ae90c671d70cd67ba20d",
+        "1a7330edbcb3b2cf50c6a933e629cf7a",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "dfff05906bfaf706ab6c750b1cce541a968da5642f488d51c6934239677d9ff63a2de53a56c5a31a"
+        "40efdeea99f4ec4d8733698718bf16bd95b4a073475b28b5",
+    },
+    {
+        AES_AES256,
+        1,
+        "102c381947683541c722696e09c7053dd2cbeeb3f019e605629f32f8c11fadf4",
+        "40b9317fb36cda5d612f8a3f8b3a6df0",
+        "da03aa5c36c3aa9cda0f50a157e02db728ed296bd5e7eca770585550ac4c4076",
+        "78cc06c940c7f2deece3bd3a521fb2172eabdf12e7e0e77cf9623944d5e0cc5f",
+        "adbbdb69cf832adb442af8267525e7497dc8a03c90a94a5ddb104b616d4be8e3",
+        "6e431eabfb7993ec60a13e663b6777fb58f76181e2f03330aa12f9ce166c1747",
+        "d5f3271c0949fe89bcfbbb67875c85cea12908da35b73022c5c580453ba5d804",
+        "69ac312474571c1ea49776ef310055de53da577aff09b796da80b62e06a089981b1a1f6f9ef85946"
+        "c43091fdc8aaf227e3f6eeb0568e856ce1cfaff6f1e701ec",
+    },
+    {
+        AES_AES256,
+        0,
+        "e2ce3e1499d6d20d9c59c79ea8060e5e23da20d8f67ad155a297d35125dcbdb197dc15b56b0a4a11"
+        "2016ad94eb290e67",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "",
+        "544aefb874524ace770ee5bda24b3cab885f9c8e2d8c003b69c1bda137aa76e3cd0ddedbfc45eedf"
+        "749024cbfb260ae00954e0f58bd7f490ff36706820ee2e81",
+    },
+    {
+        AES_AES256,
+        0,
+        "e4e7df55e8043f6518e546c6c434a75b0d51af5e20e93d6b2fe51fd619877b99ab979c3a1e980192"
+        "0a79759a12da71e5",
+        "",
+        "803645b666f535500e2e3b8f0a539f831140fadaf2dda196ebf5a98b086bec51c86157dbda4d395a"
+        "5287bb7770e8eccd",
+        "82c41cb747b62c28d643a13751f5d4e0c9b976d705165ef80f4ebc4ffd271658d288efd043dcc413"
+        "7a1d253ff135ceee",
+        "bf13f431cd490a99858002e76d8505a179a4204949452657b913055655dd675f50137f9cbd7564aa"
+        "9d537efcfded6cfa",
+        "4cb616f8072b027ac2fa7d1f5c5e8e2585b14804ab276f24a5e944e663834e106ebe3cc548563d64"
+        "1d1ae8789c02d80b",
+        "047559569db4f1a9186addab39648962c9ea0f0633ca2e1aa95bd558abf0f9536e74028421b03634"
+        "c29b4963310d34b5",
+        "70ba80b28176db3aead8e216158f1175a4078a52b1e720c31fecad80f12065b112b192c0c64d40e9"
+        "4b2288302a0f2a6325d3d9e4e916c65f669e89ef683d27e1",
+    },
+};
+
+typedef struct {
+    unsigned char entropy[64];
+    unsigned char nonce[64];
+    unsigned char personalization[64];
+    unsigned char entropy_reseed[64];
+    unsigned char additional_reseed[64];
+    unsigned char additional1[64];
+    unsigned char additional2[64];
+    unsigned char returned[64];
+} Inputs;
+
+static void test_known_answer(const KnownAnswer* known_answer) {
+    Inputs inputs;
+    unsigned char actual[64];
+    AES_CtrDrbg drbg;
+
+    const size_t entropy_size = test_parse_hex(known_answer->entropy, inputs.entropy);
+    const size_t nonce_size = test_parse_hex(known_answer->nonce, inputs.nonce);
+    const size_t personalization_size =
+        test_parse_hex(known_answer->personalization, inputs.personalization);
+    const size_t entropy_reseed_size =
+        test_parse_hex(known_answer->entropy_reseed, inputs.entropy_reseed);
+    const size_t additional_reseed_size =
+        test_parse_hex(known_answer->additional_reseed, inputs.additional_reseed);
+    const size_t additional1_size = test_parse_hex(known_answer->additional1, inputs.additional1);
+    const size_t additional2_size = test_parse_hex(known_answer->additional2, inputs.additional2);
+    const size_t returned_size = test_parse_hex(known_answer->returned, inputs.returned);
+
+    if (!TEST_CHECK_SUCCESS(aes_ctr_drbg_init(
+            &drbg,
+            known_answer->algorithm,
+            known_answer->use_df,
+            inputs.entropy,
+            entropy_size,
+            inputs.nonce,
+            nonce_size,
+            inputs.personalization,
+            personalization_size,
+            NULL
+        )))
+        return;
+
+    if (entropy_reseed_size != 0)
+        TEST_CHECK_SUCCESS(aes_ctr_drbg_reseed(
+            &drbg,
+            inputs.entropy_reseed,
+            entropy_reseed_size,
+            inputs.additional_reseed,
+            additional_reseed_size,
+            NULL
+        ));
+
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate(
+        &drbg, actual, returned_size, inputs.additional1, additional1_size, NULL
+    ));
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate(
+        &drbg, actual, returned_size, inputs.additional2, additional2_size, NULL
+    ));
+
+    if (!TEST_CHECK(memcmp(actual, inputs.returned, returned_size) == 0))
+        fprintf(
+            stderr,
+            "algorithm %d, use_df %d, entropy %s\n",
+            (int)known_answer->algorithm,
+            known_answer->use_df,
+            known_answer->entropy
+        );
+}
+
+/* Once reseed_interval requests have been made, a reseed is required. */
+static void test_reseed_interval(void) {
+    unsigned char entropy[32], dest[16];
+    AES_CtrDrbg drbg;
+
+    test_fill(entropy, sizeof(entropy), 0);
+    if (!TEST_CHECK_SUCCESS(
+            aes_ctr_drbg_init(&drbg, AES_AES128, 0, entropy, 32, NULL, 0, NULL, 0, NULL)
+        ))
+        return;
+
+    drbg.reseed_interval = 2;
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate(&drbg, dest, sizeof(dest), NULL, 0, NULL));
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate(&drbg, dest, sizeof(dest), NULL, 0, NULL));
+    TEST_CHECK_STATUS(
+        aes_ctr_drbg_generate(&drbg, dest, sizeof(dest), NULL, 0, NULL), AES_RESEED_REQUIRED_ERROR
+    );
+
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_reseed(&drbg, entropy, 32, NULL, 0, NULL));
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate(&drbg, dest, sizeof(dest), NULL, 0, NULL));
+}
+
+/* The thread-local instance mustn't repeat itself, in a forked child process
+ * either. */
+static void test_thread_local(void) {
+    unsigned char a[32], b[32];
+
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate_thread_local(a, sizeof(a), NULL));
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate_thread_local(b, sizeof(b), NULL));
+    TEST_CHECK(memcmp(a, b, sizeof(a)) != 0);
+
+#ifndef WIN32
+    int fds[2];
+    if (!TEST_CHECK(pipe(fds) == 0))
+        return;
+
+    const pid_t pid = fork();
+    if (!TEST_CHECK(pid >= 0))
+        return;
+
+    TEST_CHECK_SUCCESS(aes_ctr_drbg_generate_thread_local(a, sizeof(a), NULL));
+    if (pid == 0) {
+        const ssize_t written = write(fds[1], a, sizeof(a));
+        _exit(written == (ssize_t)sizeof(a) ? 0 : 1);
+    }
+
+    TEST_CHECK(read(fds[0], b, sizeof(b)) == (ssize_t)sizeof(b));
+    TEST_CHECK(waitpid(pid, NULL, 0) == pid);
+    TEST_CHECK(memcmp(a, b, sizeof(a)) != 0);
+    close(fds[0]);
+    close(fds[1]);
+#endif
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(known_answers) / sizeof(known_answers[0]); ++i)
+        test_known_answer(&known_answers[i]);
+
+    test_reseed_interval();
+    test_thread_local();
+
+    return test_finish("drbg");
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+static unsigned char src[TEST_MAX_MESSAGE_SIZE];
+static unsigned char expected[TEST_MAX_MESSAGE_SIZE];
+static unsigned char buf[TEST_MAX_MESSAGE_SIZE];
+
+static const unsigned char aad[] = "additional authenticated data";
+
+/* Every message is encrypted by a fresh box, so that the authenticated modes
+ * don't reuse the init vector. */
+static int init_box(AES_Box* box, AES_Algorithm algorithm, AES_Mode mode) {
+    if (!TEST_CHECK_SUCCESS(test_init_box(box, algorithm, mode, (unsigned int)mode)))
+        return 0;
+    if (aes_mode_is_authenticated(mode))
+        return TEST_CHECK_SUCCESS(aes_box_set_aad(box, aad, sizeof(aad), NULL));
+    return 1;
+}
+
+/* Encrypting & decrypting in place (using both the in-place functions &
+ * the buffer functions with src == dest) must produce the same results as
+ * doing it out of place. */
+static void test_inplace(AES_Algorithm algorithm, AES_Mode mode, size_t src_size) {
+    AES_Box box;
+    size_t expected_size = 0, dest_size = 0;
+
+    if (mode == AES_XTS && src_size < 16)
+        return;
+
+    test_fill(src, src_size, (unsigned int)src_size);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypted_size(&box, src_size, &expected_size, NULL));
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, src, src_size, expected, &dest_size, NULL));
+    TEST_CHECK(dest_size == expected_size);
+
+    memcpy(buf, src, src_size);
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_inplace(&box, buf, src_size, &dest_size, NULL));
+    TEST_CHECK(dest_size == expected_size);
+    if (!TEST_CHECK(memcmp(buf, expected, expected_size) == 0))
+        fprintf(
+            stderr,
+            "%s, algorithm %d, %zu bytes\n",
+            test_get_mode_name(mode),
+            (int)algorithm,
+            src_size
+        );
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_decrypt_inplace(&box, buf, expected_size, &dest_size, NULL));
+    TEST_CHECK(dest_size == src_size);
+    TEST_CHECK(memcmp(buf, src, src_size) == 0);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, buf, src_size, buf, &dest_size, NULL));
+    TEST_CHECK(dest_size == expected_size);
+    TEST_CHECK(memcmp(buf, expected, expected_size) == 0);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_decrypt_buffer(&box, buf, expected_size, buf, &dest_size, NULL));
+    TEST_CHECK(dest_size == src_size);
+    TEST_CHECK(memcmp(buf, src, src_size) == 0);
+}
+
+int main(void) {
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (int mode = AES_ECB; mode < TEST_NUMOF_MODES; ++mode)
+            for (size_t i = 0; i < TEST_NUMOF_MESSAGE_SIZES; ++i)
+                test_inplace((AES_Algorithm)algorithm, (AES_Mode)mode, test_get_message_size(i));
+
+    return test_finish("inplace");
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+#define MAX_NUMOF_SEGMENTS 1024
+
+static unsigned char src[TEST_MAX_MESSAGE_SIZE];
+static unsigned char expected[TEST_MAX_MESSAGE_SIZE];
+static unsigned char actual[TEST_MAX_MESSAGE_SIZE];
+
+/* The segments are spread across these, with gaps in between. */
+static unsigned char src_pool[4 * TEST_MAX_MESSAGE_SIZE];
+static unsigned char dest_pool[4 * TEST_MAX_MESSAGE_SIZE];
+
+static AES_IoVec src_iov[MAX_NUMOF_SEGMENTS + 1];
+static AES_IoVec dest_iov[MAX_NUMOF_SEGMENTS];
+
+static const unsigned char aad[] = "additional authenticated data";
+
+static int init_box(AES_Box* box, AES_Algorithm algorithm, AES_Mode mode) {
+    if (!TEST_CHECK_SUCCESS(test_init_box(box, algorithm, mode, (unsigned int)mode)))
+        return 0;
+    if (aes_mode_is_authenticated(mode))
+        return TEST_CHECK_SUCCESS(aes_box_set_aad(box, aad, sizeof(aad), NULL));
+    return 1;
+}
+
+/* Splits size bytes into segments, which mostly straddle block boundaries
+ * (some are empty), and copies data (if any) to them.
+ * Returns the number of segments. */
+static size_t scatter(
+    AES_IoVec* iov,
+    unsigned char* pool,
+    const unsigned char* data,
+    size_t size,
+    size_t pattern
+) {
+    static const size_t sizes[] = {1, 5, 15, 17, 3, 0, 64, 100, 31, 16, 257, 33};
+    static const size_t numof_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    size_t numof_segments = 0, pool_offset = 0;
+
+    for (size_t offset = 0; offset < size; ++numof_segments) {
+        size_t segment_size = sizes[(numof_segments + pattern) % numof_sizes];
+        if (segment_size > size - offset)
+            segment_size = size - offset;
+
+        iov[numof_segments].base = pool + pool_offset;
+        iov[numof_segments].size = segment_size;
+        if (data != NULL)
+            memcpy(iov[numof_segments].base, data + offset, segment_size);
+
+        offset += segment_size;
+        pool_offset += segment_size + 3;
+    }
+
+    return numof_segments;
+}
+
+/* Copies the first size bytes of the segments to dest. */
+static void gather(const AES_IoVec* iov, unsigned char* dest, size_t size) {
+    for (size_t offset = 0; offset < size; ++iov) {
+        const size_t segment_size = iov->size < size - offset ? iov->size : size - offset;
+        memcpy(dest + offset, iov->base, segment_size);
+        offset += segment_size;
+    }
+}
+
+/* The segments must be processed the same way aes_box_encrypt_buffer &
+ * aes_box_decrypt_buffer would process the whole message. */
+static void test_iov(AES_Algorithm algorithm, AES_Mode mode, size_t src_size, size_t pattern) {
+    AES_Box box;
+    size_t expected_size = 0, dest_size = 0, max_decrypted_size = 0;
+
+    if (mode == AES_XTS && src_size < 16)
+        return;
+
+    test_fill(src, src_size, (unsigned int)(src_size + pattern));
+    memset(dest_pool, 0xee, sizeof(dest_pool));
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, src, src_size, expected, &expected_size, NULL));
+    TEST_CHECK_SUCCESS(aes_box_max_decrypted_size(&box, expected_size, &max_decrypted_size, NULL));
+
+    /* The destination segments are split differently. */
+    size_t numof_src = scatter(src_iov, src_pool, src, src_size, pattern);
+    size_t numof_dest = scatter(dest_iov, dest_pool, NULL, expected_size, pattern + 5);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(
+        aes_box_encrypt_iov(&box, src_iov, numof_src, dest_iov, numof_dest, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == expected_size);
+    gather(dest_iov, actual, expected_size);
+    if (!TEST_CHECK(memcmp(actual, expected, expected_size) == 0))
+        fprintf(
+            stderr,
+            "%s, algorithm %d, %zu bytes, segment pattern %zu\n",
+            test_get_mode_name(mode),
+            (int)algorithm,
+            src_size,
+            pattern
+        );
+
+    numof_src = scatter(src_iov, src_pool, expected, expected_size, pattern + 3);
+    numof_dest = scatter(dest_iov, dest_pool, NULL, max_decrypted_size, pattern + 7);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(
+        aes_box_decrypt_iov(&box, src_iov, numof_src, dest_iov, numof_dest, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == src_size);
+    gather(dest_iov, actual, src_size);
+    TEST_CHECK(memcmp(actual, src, src_size) == 0);
+
+    /* In place: the destination is the source segments plus an extra segment
+     * for the padding or the tag. */
+    numof_src = scatter(src_iov, src_pool, src, src_size, pattern);
+    src_iov[numof_src].base = dest_pool;
+    src_iov[numof_src].size = expected_size - src_size;
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(
+        aes_box_encrypt_iov(&box, src_iov, numof_src, src_iov, numof_src + 1, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == expected_size);
+    gather(src_iov, actual, expected_size);
+    TEST_CHECK(memcmp(actual, expected, expected_size) == 0);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_SUCCESS(
+        aes_box_decrypt_iov(&box, src_iov, numof_src + 1, src_iov, numof_src + 1, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == src_size);
+    gather(src_iov, actual, src_size);
+    TEST_CHECK(memcmp(actual, src, src_size) == 0);
+
+    /* A byte short. */
+    if (expected_size == 0)
+        return;
+    numof_src = scatter(src_iov, src_pool, src, src_size, pattern);
+    numof_dest = scatter(dest_iov, dest_pool, NULL, expected_size - 1, pattern + 5);
+
+    if (!init_box(&box, algorithm, mode))
+        return;
+    TEST_CHECK_STATUS(
+        aes_box_encrypt_iov(&box, src_iov, numof_src, dest_iov, numof_dest, &dest_size, NULL),
+        AES_BUFFER_TOO_SMALL_ERROR
+    );
+}
+
+int main(void) {
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (int mode = AES_ECB; mode < TEST_NUMOF_MODES; ++mode)
+            for (size_t i = 0; i < TEST_NUMOF_MESSAGE_SIZES; ++i)
+                for (size_t pattern = 0; pattern < 4; ++pattern)
+                    test_iov(
+                        (AES_Algorithm)algorithm, (AES_Mode)mode, test_get_message_size(i), pattern
+                    );
+
+    return test_finish("iov");
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+static unsigned char src[TEST_MAX_MESSAGE_SIZE];
+static unsigned char expected[TEST_MAX_MESSAGE_SIZE];
+static unsigned char keystream[TEST_MAX_MESSAGE_SIZE];
+static unsigned char actual[TEST_MAX_MESSAGE_SIZE];
+
+/* The keystream is generated in chunks of chunk_blocks blocks (the whole
+ * keystream at once if 0) & applied to the message, which must produce the
+ * same ciphertext as aes_box_encrypt_buffer. */
+static void test_keystream(
+    AES_Algorithm algorithm,
+    AES_Mode mode,
+    size_t src_size,
+    size_t chunk_blocks
+) {
+    const unsigned int seed = (unsigned int)(algorithm * 100 + mode * 10);
+    const size_t keystream_size = (src_size + 15) / 16 * 16;
+    const size_t chunk_size = chunk_blocks == 0 ? keystream_size : chunk_blocks * 16;
+    AES_Box box;
+    size_t dest_size = 0;
+
+    test_fill(src, src_size, (unsigned int)src_size);
+
+    if (!TEST_CHECK_SUCCESS(test_init_box(&box, algorithm, mode, seed)))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, src, src_size, expected, &dest_size, NULL));
+    TEST_CHECK(dest_size == src_size);
+
+    if (!TEST_CHECK_SUCCESS(test_init_box(&box, algorithm, mode, seed)))
+        return;
+    for (size_t offset = 0; offset < keystream_size; offset += chunk_size) {
+        const size_t remaining = keystream_size - offset;
+        TEST_CHECK_SUCCESS(aes_box_generate_keystream(
+            &box, keystream + offset, remaining < chunk_size ? remaining : chunk_size, NULL
+        ));
+    }
+
+    TEST_CHECK_SUCCESS(aes_apply_keystream(src, src_size, keystream, actual, NULL));
+    if (!TEST_CHECK(memcmp(actual, expected, src_size) == 0))
+        fprintf(
+            stderr,
+            "%s, algorithm %d, %zu bytes, chunks of %zu blocks\n",
+            test_get_mode_name(mode),
+            (int)algorithm,
+            src_size,
+            chunk_blocks
+        );
+
+    /* Decryption is the same thing. */
+    TEST_CHECK_SUCCESS(aes_apply_keystream(expected, src_size, keystream, actual, NULL));
+    TEST_CHECK(memcmp(actual, src, src_size) == 0);
+}
+
+int main(void) {
+    static const AES_Mode modes[] = {AES_OFB, AES_CTR};
+    static const size_t chunks[] = {0, 1, 3, 8, 33};
+
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i)
+            for (size_t j = 0; j < TEST_NUMOF_MESSAGE_SIZES; ++j)
+                for (size_t k = 0; k < sizeof(chunks) / sizeof(chunks[0]); ++k)
+                    test_keystream(
+                        (AES_Algorithm)algorithm, modes[i], test_get_message_size(j), chunks[k]
+                    );
+
+    /* The keystream doesn't exist in the other modes. */
+    for (int mode = AES_ECB; mode < TEST_NUMOF_MODES; ++mode) {
+        if (mode == AES_OFB || mode == AES_CTR)
+            continue;
+
+        AES_Box box;
+        if (!TEST_CHECK_SUCCESS(test_init_box(&box, AES_AES128, (AES_Mode)mode, 0)))
+            continue;
+        TEST_CHECK_STATUS(
+            aes_box_generate_keystream(&box, keystream, 16, NULL), AES_NOT_IMPLEMENTED_ERROR
+        );
+    }
+
+    return test_finish("keystream");
+}
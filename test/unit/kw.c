@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+typedef struct {
+    int padding;
+    AES_Algorithm algorithm;
+    const char* kek;
+    const char* key;
+    const char* wrapped;
+} KnownAnswer;
+
+/* The examples from RFC 3394 (section 4) & RFC 5649 (section 6). */
+static const KnownAnswer known_answers[] = {
+    {
+        0,
+        AES_AES128,
+        "000102030405060708090a0b0c0d0e0f",
+        "00112233445566778899aabbccddeeff",
+        "1fa68b0a8112b447aef34bd8fb5a7b829d3e862371d2cfe5",
+    },
+    {
+        0,
+        AES_AES192,
+        "000102030405060708090a0b0c0d0e0f1011121314151617",
+        "00112233445566778899aabbccddeeff",
+        "96778b25ae6ca435f92b5b97c050aed2468ab8a17ad84e5d",
+    },
+    {
+        0,
+        AES_AES256,
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "00112233445566778899aabbccddeeff",
+        "64e8c3f9ce0f5ba263e9777905818a2a93c8191e7d6e8ae7",
+    },
+    {
+        0,
+        AES_AES192,
+        "000102030405060708090a0b0c0d0e0f1011121314151617",
+        "00112233445566778899aabbccddeeff0001020304050607",
+        "031d33264e15d33268f24ec260743edce1c6c7ddee725a936ba814915c6762d2",
+    },
+    {
+        0,
+        AES_AES256,
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "00112233445566778899aabbccddeeff0001020304050607",
+        "a8f9bc1612c68b3ff6e6f4fbe30e71e4769c8b80a32cb8958cd5d17d6b254da1",
+    },
+    {
+        0,
+        AES_AES256,
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "00112233445566778899aabbccddeeff000102030405060708090a0b0c0d0e0f",
+        "28c9f404c4b810f4cbccb35cfb87f8263f5786e2d80ed326cbc7f0e71a99f43bfb988b9b7a02dd21",
+    },
+    {
+        1,
+        AES_AES192,
+        "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8",
+        "c37b7e6492584340bed12207808941155068f738",
+        "138bdeaa9b8fa7fc61f97742e72248ee5ae6ae5360d1ae6a5f54f373fa543b6a",
+    },
+    {
+        1,
+        AES_AES192,
+        "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8",
+        "466f7250617369",
+        "afbeb0f07dfbf5419200f2ccb50bb24f",
+    },
+};
+
+typedef AES_StatusCode (*WrapFn)(
+    const AES_Kw*,
+    const void*,
+    size_t,
+    void*,
+    size_t*,
+    AES_ErrorDetails*
+);
+
+typedef AES_StatusCode (*WrapBatchFn)(
+    const AES_Kw*,
+    const void* const*,
+    const size_t*,
+    size_t,
+    void* const*,
+    size_t*,
+    AES_ErrorDetails*
+);
+
+static WrapFn get_wrap_fn(int padding) {
+    return padding ? &aes_kwp_wrap : &aes_kw_wrap;
+}
+
+static WrapFn get_unwrap_fn(int padding) {
+    return padding ? &aes_kwp_unwrap : &aes_kw_unwrap;
+}
+
+static WrapBatchFn get_wrap_batch_fn(int padding) {
+    return padding ? &aes_kwp_wrap_batch : &aes_kw_wrap_batch;
+}
+
+static WrapBatchFn get_unwrap_batch_fn(int padding) {
+    return padding ? &aes_kwp_unwrap_batch : &aes_kw_unwrap_batch;
+}
+
+static int is_zero(const unsigned char* src, size_t src_size) {
+    for (size_t i = 0; i < src_size; ++i)
+        if (src[i] != 0)
+            return 0;
+    return 1;
+}
+
+static void test_known_answer(const KnownAnswer* known_answer) {
+    unsigned char key[64], wrapped[64], actual[64];
+    AES_Key kek;
+    AES_Kw kw;
+    size_t dest_size = 0;
+
+    const size_t key_size = test_parse_hex(known_answer->key, key);
+    const size_t wrapped_size = test_parse_hex(known_answer->wrapped, wrapped);
+
+    if (!TEST_CHECK_SUCCESS(aes_parse_key(known_answer->algorithm, &kek, known_answer->kek, NULL)))
+        return;
+    if (!TEST_CHECK_SUCCESS(aes_kw_init(&kw, known_answer->algorithm, &kek, NULL)))
+        return;
+
+    TEST_CHECK_SUCCESS(
+        get_wrap_fn(known_answer->padding)(&kw, key, key_size, actual, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == wrapped_size);
+    if (!TEST_CHECK(memcmp(actual, wrapped, wrapped_size) == 0))
+        fprintf(stderr, "wrapping %s\n", known_answer->key);
+
+    TEST_CHECK_SUCCESS(
+        get_unwrap_fn(known_answer->padding)(&kw, wrapped, wrapped_size, actual, &dest_size, NULL)
+    );
+    TEST_CHECK(dest_size == key_size);
+    if (!TEST_CHECK(memcmp(actual, key, key_size) == 0))
+        fprintf(stderr, "unwrapping %s\n", known_answer->wrapped);
+
+    /* A single flipped bit must fail the integrity check. */
+    wrapped[wrapped_size / 2] ^= 0x10;
+    memset(actual, 0xff, sizeof(actual));
+    TEST_CHECK_STATUS(
+        get_unwrap_fn(known_answer->padding)(&kw, wrapped, wrapped_size, actual, &dest_size, NULL),
+        AES_AUTHENTICATION_ERROR
+    );
+    TEST_CHECK(is_zero(actual, wrapped_size - 8));
+}
+
+#define NUMOF_KEYS (2 * AES_KW_BATCH_LEN + 5)
+#define MAX_KEY_SIZE 512
+
+static unsigned char keys[NUMOF_KEYS][MAX_KEY_SIZE];
+static unsigned char wrapped[NUMOF_KEYS][MAX_KEY_SIZE + 16];
+static unsigned char expected[NUMOF_KEYS][MAX_KEY_SIZE + 16];
+static unsigned char unwrapped[NUMOF_KEYS][MAX_KEY_SIZE + 16];
+
+static size_t get_key_size(int padding, size_t i) {
+    /* KW keys are at least 2 semiblocks long, KWP keys can be of any size. */
+    static const size_t kw_sizes[] = {16, 24, 32, 40, 64, 136, MAX_KEY_SIZE};
+    static const size_t kwp_sizes[] = {1, 7, 8, 9, 16, 17, 31, 32, 100, MAX_KEY_SIZE};
+
+    if (padding)
+        return kwp_sizes[i % (sizeof(kwp_sizes) / sizeof(kwp_sizes[0]))];
+    return kw_sizes[i % (sizeof(kw_sizes) / sizeof(kw_sizes[0]))];
+}
+
+/* The batch functions must produce the same results as the keys would have one
+ * by one. Every third key in the unwrapped batch is tampered with, which must
+ * only fail those keys. */
+static void test_batch(int padding, AES_Algorithm algorithm, size_t numof_keys) {
+    const void* srcs[NUMOF_KEYS];
+    size_t src_sizes[NUMOF_KEYS];
+    void* dests[NUMOF_KEYS];
+    size_t dest_sizes[NUMOF_KEYS];
+    AES_Key kek;
+    AES_Kw kw;
+
+    test_fill(&kek, sizeof(kek), (unsigned int)algorithm);
+    if (!TEST_CHECK_SUCCESS(aes_kw_init(&kw, algorithm, &kek, NULL)))
+        return;
+
+    for (size_t i = 0; i < numof_keys; ++i) {
+        src_sizes[i] = get_key_size(padding, i + numof_keys);
+        test_fill(keys[i], src_sizes[i], (unsigned int)i);
+        srcs[i] = keys[i];
+        dests[i] = wrapped[i];
+    }
+
+    TEST_CHECK_SUCCESS(
+        get_wrap_batch_fn(padding)(&kw, srcs, src_sizes, numof_keys, dests, dest_sizes, NULL)
+    );
+
+    for (size_t i = 0; i < numof_keys; ++i) {
+        size_t expected_size = 0;
+
+        TEST_CHECK_SUCCESS(
+            get_wrap_fn(padding)(&kw, keys[i], src_sizes[i], expected[i], &expected_size, NULL)
+        );
+        TEST_CHECK(dest_sizes[i] == expected_size);
+        if (!TEST_CHECK(memcmp(wrapped[i], expected[i], expected_size) == 0))
+            fprintf(
+                stderr,
+                "padding %d, algorithm %d, key %zu of %zu (%zu bytes)\n",
+                padding,
+                (int)algorithm,
+                i,
+                numof_keys,
+                src_sizes[i]
+            );
+
+        srcs[i] = wrapped[i];
+        src_sizes[i] = dest_sizes[i];
+        dests[i] = unwrapped[i];
+    }
+
+    TEST_CHECK_SUCCESS(
+        get_unwrap_batch_fn(padding)(&kw, srcs, src_sizes, numof_keys, dests, dest_sizes, NULL)
+    );
+    for (size_t i = 0; i < numof_keys; ++i) {
+        TEST_CHECK(dest_sizes[i] == get_key_size(padding, i + numof_keys));
+        TEST_CHECK(memcmp(unwrapped[i], keys[i], dest_sizes[i]) == 0);
+    }
+
+    for (size_t i = 0; i < numof_keys; i += 3)
+        wrapped[i][src_sizes[i] - 1] ^= 0x01;
+
+    TEST_CHECK_STATUS(
+        get_unwrap_batch_fn(padding)(&kw, srcs, src_sizes, numof_keys, dests, dest_sizes, NULL),
+        numof_keys == 0 ? AES_SUCCESS : AES_AUTHENTICATION_ERROR
+    );
+    for (size_t i = 0; i < numof_keys; ++i) {
+        if (i % 3 == 0) {
+            TEST_CHECK(dest_sizes[i] == 0);
+        } else {
+            TEST_CHECK(dest_sizes[i] == get_key_size(padding, i + numof_keys));
+            TEST_CHECK(memcmp(unwrapped[i], keys[i], dest_sizes[i]) == 0);
+        }
+    }
+}
+
+int main(void) {
+    static const size_t batch_sizes[] = {
+        0,
+        1,
+        7,
+        AES_KW_BATCH_LEN - 1,
+        AES_KW_BATCH_LEN,
+        AES_KW_BATCH_LEN + 1,
+        NUMOF_KEYS,
+    };
+
+    for (size_t i = 0; i < sizeof(known_answers) / sizeof(known_answers[0]); ++i)
+        test_known_answer(&known_answers[i]);
+
+    for (int padding = 0; padding <= 1; ++padding)
+        for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+            for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); ++i)
+                test_batch(padding, (AES_Algorithm)algorithm, batch_sizes[i]);
+
+    return test_finish("kw");
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+#define MAX_NUMOF_SECTORS 40
+#define MAX_SECTOR_SIZE 4096
+
+static unsigned char src[MAX_NUMOF_SECTORS * MAX_SECTOR_SIZE];
+static unsigned char expected[MAX_NUMOF_SECTORS * MAX_SECTOR_SIZE];
+static unsigned char actual[MAX_NUMOF_SECTORS * MAX_SECTOR_SIZE];
+
+/* The tweak of a sector is its number, as a 128-bit little-endian number. */
+static AES_Block get_sector_tweak(unsigned long long sector) {
+    unsigned char bytes[16] = {0};
+    AES_Block tweak;
+
+    for (int i = 0; i < 8; ++i)
+        bytes[i] = (unsigned char)(sector >> (8 * i));
+    memcpy(&tweak, bytes, sizeof(tweak));
+    return tweak;
+}
+
+/* Every sector must be encrypted the same way a separate box with the sector
+ * number for the init vector would encrypt it. */
+static void test_sectors(
+    AES_Algorithm algorithm,
+    size_t sector_size,
+    size_t numof_sectors,
+    unsigned long long first_sector
+) {
+    const unsigned int seed = (unsigned int)(algorithm + sector_size);
+    const size_t total_size = sector_size * numof_sectors;
+    AES_Box box;
+
+    test_fill(src, total_size, (unsigned int)(numof_sectors + first_sector));
+
+    for (size_t i = 0; i < numof_sectors; ++i) {
+        const AES_Block tweak = get_sector_tweak(first_sector + i);
+        size_t dest_size = 0;
+
+        if (!TEST_CHECK_SUCCESS(test_init_box(&box, algorithm, AES_XTS, seed)))
+            return;
+        TEST_CHECK_SUCCESS(aes_box_set_iv(&box, &tweak, NULL));
+        TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(
+            &box, src + i * sector_size, sector_size, expected + i * sector_size, &dest_size, NULL
+        ));
+    }
+
+    if (!TEST_CHECK_SUCCESS(test_init_box(&box, algorithm, AES_XTS, seed)))
+        return;
+
+    TEST_CHECK_SUCCESS(
+        aes_box_encrypt_sectors(&box, src, sector_size, numof_sectors, first_sector, actual, NULL)
+    );
+    if (!TEST_CHECK(memcmp(actual, expected, total_size) == 0))
+        fprintf(
+            stderr,
+            "algorithm %d, %zu sectors of %zu bytes, starting with %llu\n",
+            (int)algorithm,
+            numof_sectors,
+            sector_size,
+            first_sector
+        );
+
+    TEST_CHECK_SUCCESS(aes_box_decrypt_sectors(
+        &box, expected, sector_size, numof_sectors, first_sector, actual, NULL
+    ));
+    TEST_CHECK(memcmp(actual, src, total_size) == 0);
+
+    /* In place. */
+    memcpy(actual, src, total_size);
+    TEST_CHECK_SUCCESS(aes_box_encrypt_sectors(
+        &box, actual, sector_size, numof_sectors, first_sector, actual, NULL
+    ));
+    TEST_CHECK(memcmp(actual, expected, total_size) == 0);
+    TEST_CHECK_SUCCESS(aes_box_decrypt_sectors(
+        &box, actual, sector_size, numof_sectors, first_sector, actual, NULL
+    ));
+    TEST_CHECK(memcmp(actual, src, total_size) == 0);
+}
+
+int main(void) {
+    static const size_t sector_sizes[] = {16, 17, 31, 48, 496, 512, 520, MAX_SECTOR_SIZE};
+    static const size_t numof_sectors[] = {1, 2, 7, 8, 9, 33, MAX_NUMOF_SECTORS};
+    static const unsigned long long first_sectors[] = {
+        0,
+        1,
+        1000,
+        0xfffffff0ull,
+        0xfffffffffffffff0ull,
+    };
+
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (size_t i = 0; i < sizeof(sector_sizes) / sizeof(sector_sizes[0]); ++i)
+            for (size_t j = 0; j < sizeof(numof_sectors) / sizeof(numof_sectors[0]); ++j)
+                for (size_t k = 0; k < sizeof(first_sectors) / sizeof(first_sectors[0]); ++k)
+                    test_sectors(
+                        (AES_Algorithm)algorithm,
+                        sector_sizes[i],
+                        numof_sectors[j],
+                        first_sectors[k]
+                    );
+
+    /* Sectors only exist in XTS mode, and are at least a block long. */
+    AES_Box box;
+    if (TEST_CHECK_SUCCESS(test_init_box(&box, AES_AES128, AES_CBC, 0)))
+        TEST_CHECK_STATUS(
+            aes_box_encrypt_sectors(&box, src, 512, 1, 0, actual, NULL), AES_NOT_IMPLEMENTED_ERROR
+        );
+    if (TEST_CHECK_SUCCESS(test_init_box(&box, AES_AES128, AES_XTS, 0)))
+        TEST_CHECK(aes_is_error(aes_box_encrypt_sectors(&box, src, 15, 1, 0, actual, NULL)));
+
+    /* XTS isn't defined for AES-192. */
+    AES_Key key, tweak_key;
+    test_fill(&key, sizeof(key), 0);
+    test_fill(&tweak_key, sizeof(tweak_key), 1);
+    TEST_CHECK_STATUS(
+        aes_box_init_xts(&box, AES_AES192, &key, &tweak_key, NULL, NULL), AES_NOT_IMPLEMENTED_ERROR
+    );
+
+    return test_finish("sectors");
+}
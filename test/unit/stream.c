@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#include "test.h"
+
+static unsigned char src[TEST_MAX_MESSAGE_SIZE];
+static unsigned char expected[TEST_MAX_MESSAGE_SIZE];
+static unsigned char actual[TEST_MAX_MESSAGE_SIZE];
+static unsigned char decrypted[TEST_MAX_MESSAGE_SIZE];
+
+static const unsigned char aad[] = "additional authenticated data";
+
+/* The chunk sizes go through this list, so that the chunks end at odd
+ * offsets, both inside blocks & on their boundaries. */
+static size_t get_chunk_size(size_t i, size_t pattern) {
+    static const size_t sizes[] = {1, 15, 16, 17, 3, 32, 100, 7, 513, 31, 2, 48};
+    return sizes[(i + pattern) % (sizeof(sizes) / sizeof(sizes[0]))];
+}
+
+static AES_StatusCode init_box(AES_Box* box, AES_Algorithm algorithm, AES_Mode mode) {
+    AES_StatusCode status = test_init_box(box, algorithm, mode, (unsigned int)mode);
+    if (aes_is_error(status))
+        return status;
+    if (aes_mode_is_authenticated(mode))
+        return aes_box_set_aad(box, aad, sizeof(aad), NULL);
+    return status;
+}
+
+typedef AES_StatusCode (*UpdateFn)(
+    AES_Box*,
+    const void*,
+    size_t,
+    void*,
+    size_t*,
+    AES_ErrorDetails*
+);
+typedef AES_StatusCode (*FinalizeFn)(AES_Box*, void*, size_t*, AES_ErrorDetails*);
+
+/* Processes the input in chunks, returns the number of bytes written. */
+static size_t process_in_chunks(
+    AES_Box* box,
+    UpdateFn update,
+    FinalizeFn finalize,
+    const unsigned char* input,
+    size_t input_size,
+    unsigned char* output,
+    size_t pattern,
+    AES_StatusCode expected_status
+) {
+    size_t output_size = 0, written = 0;
+
+    for (size_t offset = 0, i = 0; offset < input_size; ++i) {
+        size_t chunk_size = get_chunk_size(i, pattern);
+        if (chunk_size > input_size - offset)
+            chunk_size = input_size - offset;
+
+        TEST_CHECK_SUCCESS(
+            update(box, input + offset, chunk_size, output + output_size, &written, NULL)
+        );
+        TEST_CHECK(written % 16 == 0 && written <= chunk_size + 15);
+        output_size += written;
+        offset += chunk_size;
+    }
+
+    TEST_CHECK_STATUS(finalize(box, output + output_size, &written, NULL), expected_status);
+    TEST_CHECK(written <= AES_BOX_FINALIZE_MAX_SIZE);
+    return output_size + written;
+}
+
+static void test_stream(AES_Algorithm algorithm, AES_Mode mode, size_t src_size, size_t pattern) {
+    AES_Box box;
+    size_t expected_size = 0;
+
+    if (mode == AES_XTS && src_size < 16)
+        return;
+
+    test_fill(src, src_size, (unsigned int)(src_size + pattern));
+
+    if (!TEST_CHECK_SUCCESS(init_box(&box, algorithm, mode)))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, src, src_size, expected, &expected_size, NULL));
+
+    if (!TEST_CHECK_SUCCESS(init_box(&box, algorithm, mode)))
+        return;
+    const size_t actual_size = process_in_chunks(
+        &box,
+        &aes_box_encrypt_update,
+        &aes_box_encrypt_finalize,
+        src,
+        src_size,
+        actual,
+        pattern,
+        AES_SUCCESS
+    );
+
+    TEST_CHECK(actual_size == expected_size);
+    if (!TEST_CHECK(memcmp(actual, expected, expected_size) == 0))
+        fprintf(
+            stderr,
+            "%s, algorithm %d, %zu bytes, chunk pattern %zu\n",
+            test_get_mode_name(mode),
+            (int)algorithm,
+            src_size,
+            pattern
+        );
+
+    if (!TEST_CHECK_SUCCESS(init_box(&box, algorithm, mode)))
+        return;
+    const size_t decrypted_size = process_in_chunks(
+        &box,
+        &aes_box_decrypt_update,
+        &aes_box_decrypt_finalize,
+        expected,
+        expected_size,
+        decrypted,
+        pattern,
+        AES_SUCCESS
+    );
+
+    TEST_CHECK(decrypted_size == src_size);
+    TEST_CHECK(memcmp(decrypted, src, src_size) == 0);
+
+    /* A tampered tag must be noticed by finalize. */
+    if (aes_mode_is_authenticated(mode)) {
+        expected[expected_size - 1] ^= 0x01;
+        if (!TEST_CHECK_SUCCESS(init_box(&box, algorithm, mode)))
+            return;
+        process_in_chunks(
+            &box,
+            &aes_box_decrypt_update,
+            &aes_box_decrypt_finalize,
+            expected,
+            expected_size,
+            decrypted,
+            pattern,
+            AES_AUTHENTICATION_ERROR
+        );
+    }
+}
+
+/* The AAD can't be changed in the middle of a message, which must be left
+ * intact, but can be set for the next one. */
+static void test_aad_in_the_middle(AES_Mode mode) {
+    AES_Box box;
+    size_t expected_size = 0, actual_size = 0, written = 0;
+
+    test_fill(src, 100, (unsigned int)mode);
+
+    if (!TEST_CHECK_SUCCESS(init_box(&box, AES_AES128, mode)))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_buffer(&box, src, 100, expected, &expected_size, NULL));
+
+    if (!TEST_CHECK_SUCCESS(init_box(&box, AES_AES128, mode)))
+        return;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_update(&box, src, 33, actual, &written, NULL));
+    actual_size += written;
+    TEST_CHECK_STATUS(aes_box_set_aad(&box, aad, 7, NULL), AES_NOT_IMPLEMENTED_ERROR);
+    TEST_CHECK_SUCCESS(
+        aes_box_encrypt_update(&box, src + 33, 100 - 33, actual + actual_size, &written, NULL)
+    );
+    actual_size += written;
+    TEST_CHECK_SUCCESS(aes_box_encrypt_finalize(&box, actual + actual_size, &written, NULL));
+    actual_size += written;
+
+    TEST_CHECK(actual_size == expected_size);
+    TEST_CHECK(memcmp(actual, expected, expected_size) == 0);
+
+    TEST_CHECK_SUCCESS(aes_box_set_aad(&box, aad, sizeof(aad), NULL));
+}
+
+int main(void) {
+    for (int algorithm = AES_AES128; algorithm <= AES_AES256; ++algorithm)
+        for (int mode = AES_ECB; mode < TEST_NUMOF_MODES; ++mode) {
+            if (!aes_mode_supports_streaming((AES_Mode)mode))
+                continue;
+            for (size_t i = 0; i < TEST_NUMOF_MESSAGE_SIZES; ++i)
+                for (size_t pattern = 0; pattern < 4; ++pattern)
+                    test_stream(
+                        (AES_Algorithm)algorithm, (AES_Mode)mode, test_get_message_size(i), pattern
+                    );
+        }
+
+    test_aad_in_the_middle(AES_GCM);
+    test_aad_in_the_middle(AES_OCB);
+
+    /* CCM & GCM-SIV messages can't be processed in chunks. */
+    for (int mode = AES_ECB; mode < TEST_NUMOF_MODES; ++mode) {
+        AES_Box box;
+        size_t written = 0;
+
+        if (aes_mode_supports_streaming((AES_Mode)mode))
+            continue;
+        if (!TEST_CHECK_SUCCESS(test_init_box(&box, AES_AES128, (AES_Mode)mode, 0)))
+            continue;
+        TEST_CHECK_STATUS(
+            aes_box_encrypt_update(&box, src, 16, actual, &written, NULL), AES_NOT_IMPLEMENTED_ERROR
+        );
+    }
+
+    return test_finish("stream");
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026 Egor Tensin <egor@tensin.name>
+ * This file is part of the "AES tools" project.
+ * For details, see https://github.com/egor-tensin/aes-tools.
+ * Distributed under the MIT License.
+ */
+
+#pragma once
+
+#include <aes/all.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A failed check is reported & counted, and the test goes on.
+ * The implementation is selected as usual, so the tests run against the one
+ * named by the AES_TOOLS_IMPL environment variable. */
+
+static int test_failures = 0;
+
+static inline int test_check(int ok, const char* expr, const char* file, int line) {
+    if (!ok) {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        ++test_failures;
+    }
+    return ok;
+}
+
+static inline int test_check_status(
+    AES_StatusCode actual,
+    AES_StatusCode expected,
+    const char* expr,
+    const char* file,
+    int line
+) {
+    if (actual != expected) {
+        fprintf(
+            stderr,
+            "%s:%d: %s: expected \"%s\", got \"%s\"\n",
+            file,
+            line,
+            expr,
+            aes_strerror(expected),
+            aes_strerror(actual)
+        );
+        ++test_failures;
+    }
+    return actual == expected;
+}
+
+#define TEST_CHECK(expr) test_check((expr) ? 1 : 0, #expr, __FILE__, __LINE__)
+#define TEST_CHECK_STATUS(expr, expected) \
+    test_check_status((expr), (expected), #expr, __FILE__, __LINE__)
+#define TEST_CHECK_SUCCESS(expr) TEST_CHECK_STATUS((expr), AES_SUCCESS)
+
+static inline int test_finish(const char* name) {
+    printf(
+        "%s (%s): %d check(s) failed\n",
+        name,
+        aes_get_impl_name(aes_get_impl()),
+        test_failures
+    );
+    return test_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static inline size_t test_parse_hex(const char* src, void* dest) {
+    unsigned char* bytes = (unsigned char*)dest;
+    size_t size = 0;
+
+    for (; src[0] != '\0' && src[1] != '\0'; src += 2) {
+        unsigned int byte = 0;
+        if (sscanf(src, "%2x", &byte) != 1)
+            break;
+        bytes[size++] = (unsigned char)byte;
+    }
+
+    return size;
+}
+
+/* Deterministic pseudo-random bytes, so that a failure can be reproduced. */
+static inline void test_fill(void* dest, size_t size, unsigned int seed) {
+    unsigned char* bytes = (unsigned char*)dest;
+    unsigned int x = seed * 2654435761u + 1;
+
+    for (size_t i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        bytes[i] = (unsigned char)(x >> 24);
+    }
+}
+
+static inline const char* test_get_mode_name(AES_Mode mode) {
+    static const char* const names[] = {
+        "ECB",
+        "CBC",
+        "CFB",
+        "OFB",
+        "CTR",
+        "GCM",
+        "XTS",
+        "CCM",
+        "OCB",
+        "GCM-SIV",
+    };
+    return names[mode];
+}
+
+#define TEST_NUMOF_MODES (AES_GCM_SIV + 1)
+
+/* Initializes a box in any mode (with two keys in XTS mode), the keys & the
+ * init vector being derived from seed. */
+static inline AES_StatusCode test_init_box(
+    AES_Box* box,
+    AES_Algorithm algorithm,
+    AES_Mode mode,
+    unsigned int seed
+) {
+    AES_Key key, tweak_key;
+    AES_Block iv;
+
+    test_fill(&key, sizeof(key), seed);
+    test_fill(&tweak_key, sizeof(tweak_key), seed + 1);
+    test_fill(&iv, sizeof(iv), seed + 2);
+
+    /* XTS & GCM-SIV are only defined for AES-128 & AES-256. */
+    if ((mode == AES_XTS || mode == AES_GCM_SIV) && algorithm == AES_AES192)
+        algorithm = AES_AES256;
+    if (mode == AES_XTS)
+        return aes_box_init_xts(box, algorithm, &key, &tweak_key, &iv, NULL);
+    return aes_box_init(box, algorithm, &key, mode, &iv, NULL);
+}
+
+/* The message sizes the tests go through: around the block size, around the
+ * batch size (see AES_BOX_BATCH_LEN), and a few odd ones. */
+#define TEST_NUMOF_MESSAGE_SIZES 17
+
+static inline size_t test_get_message_size(size_t i) {
+    static const size_t sizes[TEST_NUMOF_MESSAGE_SIZES] = {
+        0, 1, 15, 16, 17, 31, 32, 33, 100, 255, 256, 511, 512, 513, 1000, 4096, 5000,
+    };
+    return sizes[i];
+}
+
+/* Fits every message above with room for the padding or the tag. */
+#define TEST_MAX_MESSAGE_SIZE 8192